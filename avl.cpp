@@ -1,121 +1,358 @@
-#include<iostream>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include "avl.h"
+#include "persistentavl.h"
+#include "treefile.h"
 using namespace std;
 
-struct Node{
-    int data, height;
-    Node*left;
-    Node*right;
+template <class F> double secondsFor(F body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
 
-    Node(int val){
-        data = val;
-        height = 1;
-        left = nullptr;
-        right = nullptr;
-    }
-};
+// Insert, lookup and erase n random keys in AVLMap and std::map
+void benchmarkAgainstStdMap(size_t n) {
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++) keys[i] = int(i);
+    mt19937 rng(12345);
+    shuffle(keys.begin(), keys.end(), rng);
+    vector<int> probes = keys;
+    shuffle(probes.begin(), probes.end(), rng);
 
-int getHeight(Node*root){
-    if(!root){
-        return 0 ;
-    }
-    else{
-        return root->height;
-    }
+    AVLMap<int, int> avl;
+    map<int, int> stdmap;
+    long found = 0;
+
+    double avlInsert = secondsFor([&] { for (int k : keys) avl.insert(k, k); });
+    double stdInsert = secondsFor([&] { for (int k : keys) stdmap.emplace(k, k); });
+    double avlFind = secondsFor([&] { for (int k : probes) found += avl.find(k) != avl.end(); });
+    double stdFind = secondsFor([&] { for (int k : probes) found += stdmap.find(k) != stdmap.end(); });
+    double avlErase = secondsFor([&] { for (int k : probes) avl.erase(k); });
+    double stdErase = secondsFor([&] { for (int k : probes) stdmap.erase(k); });
+
+    auto row = [&](const char* op, double a, double s) {
+        cout << left << setw(8) << op << right << fixed << setprecision(1)
+             << setw(12) << a * 1e9 / n << setw(12) << s * 1e9 / n
+             << setw(10) << setprecision(2) << s / a << "x\n";
+    };
+    cout << n << " random int keys (found " << found << ")\n";
+    cout << "op          AVLMap    std::map   AVL speedup  (ns/op)\n";
+    row("insert", avlInsert, stdInsert);
+    row("lookup", avlFind, stdFind);
+    row("erase", avlErase, stdErase);
 }
 
-int getFactor(Node*root){
-    if(!root){
-        return 0;
+// Bulk build from sorted keys against one insert per key, plus merges
+void benchmarkBulkBuild(size_t n) {
+    vector<int> sorted(n);
+    for (size_t i = 0; i < n; i++) sorted[i] = int(2 * i);
+    vector<int> shuffled = sorted;
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(7));
+
+    double bulk, sortedInserts, shuffledInserts;
+    {
+        AVLSet<int> s;
+        bulk = secondsFor([&] { s.assignSorted(sorted.begin(), sorted.end()); });
     }
-    else{
-        return getHeight(root->left) - getHeight(root->right);
+    {
+        AVLSet<int> s;
+        sortedInserts = secondsFor([&] { for (int k : sorted) s.insert(k); });
     }
+    {
+        AVLSet<int> s;
+        shuffledInserts = secondsFor([&] { for (int k : shuffled) s.insert(k); });
+    }
+
+    cout << "Building an AVL set of " << n << " keys\n" << fixed << setprecision(3);
+    cout << "  assignSorted          " << setw(9) << bulk << " s\n";
+    cout << "  insert, sorted input  " << setw(9) << sortedInserts << " s  ("
+         << setprecision(1) << sortedInserts / bulk << "x slower)\n" << setprecision(3);
+    cout << "  insert, random input  " << setw(9) << shuffledInserts << " s  ("
+         << setprecision(1) << shuffledInserts / bulk << "x slower)\n" << setprecision(3);
+
+    // evens merged with multiples of three
+    vector<int> threes(n);
+    for (size_t i = 0; i < n; i++) threes[i] = int(3 * i);
+    AVLSet<int> a, b;
+    a.assignSorted(sorted.begin(), sorted.end());
+    b.assignSorted(threes.begin(), threes.end());
+    size_t unionSize = 0, interSize = 0;
+    double u = secondsFor([&] { unionSize = AVLSet<int>::unionOf(a, b).size(); });
+    double x = secondsFor([&] { interSize = AVLSet<int>::intersectionOf(a, b).size(); });
+    cout << "  union        (" << unionSize << " keys) " << u << " s\n";
+    cout << "  intersection (" << interSize << " keys) " << x << " s\n";
 }
 
-Node*leftRotation(Node*root){
-   
-    Node* child = root->right;
-    Node* chilLeft = child->left;
-    child->left = root;
-    root->right = chilLeft;
+// Leaderboard queries in O(log n) against scanning the tree in order
+void benchmarkOrderStatistics(size_t n, size_t queries) {
+    using Board = AVLMap<int, long long, std::less<int>, SumOfValues<long long>>;
+    mt19937 rng(99);
+    vector<pair<int, long long>> rows(n);
+    for (size_t i = 0; i < n; i++) rows[i] = {int(2 * i), (long long)(rng() % 1000)};
+    Board board;
+    board.assignSorted(rows.begin(), rows.end());
+
+    vector<pair<int, int>> ranges(queries);
+    for (auto &r : ranges) {
+        int a = int(rng() % (2 * n)), b = int(rng() % (2 * n));
+        r = {min(a, b), max(a, b)};
+    }
+    // a scan costs O(n) per query, so it only gets a few
+    size_t scans = min(queries, max(size_t(1), size_t(2e8) / max(n, size_t(1)) / 4));
 
-    root->height = 1+ max(getHeight(root->left), getHeight(root->right));
-    child->height = 1+ max(getHeight(child->left), getHeight(child->right));
- return child;
+    long long check = 0;
+    double rankTime = secondsFor([&] { for (auto &r : ranges) check += board.rank(r.first); });
+    double selectTime = secondsFor([&] { for (auto &r : ranges) check += board.select(size_t(r.first) / 2)->first; });
+    double countTime = secondsFor([&] { for (auto &r : ranges) check += board.countRange(r.first, r.second); });
+    double sumTime = secondsFor([&] { for (auto &r : ranges) check += board.aggregateRange(r.first, r.second); });
 
+    long long treeSum = 0, scanSum = 0;
+    for (size_t q = 0; q < scans; q++) treeSum += board.aggregateRange(ranges[q].first, ranges[q].second);
+    double scanTime = secondsFor([&] {
+        for (size_t q = 0; q < scans; q++) {
+            for (auto it = board.lower_bound(ranges[q].first); it != board.end() && it->first < ranges[q].second; ++it) {
+                scanSum += it->second;
+            }
+        }
+    });
+    double fullScanTime = secondsFor([&] {
+        for (size_t q = 0; q < scans; q++) {
+            for (auto &kv : board) {
+                if (kv.first >= ranges[q].first && kv.first < ranges[q].second) scanSum += kv.second;
+            }
+        }
+    });
 
+    auto row = [&](const char* op, double secs, size_t count) {
+        cout << "  " << left << setw(30) << op << right << fixed << setprecision(1) << setw(14) << secs * 1e9 / count << " ns\n";
+    };
+    cout << "Leaderboard of " << n << " scores, " << queries << " queries (checksum " << check << ")\n";
+    row("rank", rankTime, queries);
+    row("select", selectTime, queries);
+    row("countRange", countTime, queries);
+    row("aggregateRange (sum)", sumTime, queries);
+    row("lower_bound + scan to hi", scanTime, scans);
+    row("full inorder scan", fullScanTime, scans);
+    cout << "  range sums " << (2 * treeSum == scanSum ? "match" : "DIFFER") << " the scans\n";
 }
-Node*rightRotation(Node*root){
-     Node*Child = root->left;
-    Node*childRight = Child->right;
-    Child->right = root;
-    root->left = childRight;
-    root->height = 1+ max(getHeight(root->left), getHeight(root->right));
-    Child->height = 1+ max(getHeight(Child->left), getHeight(Child->right));
-    return Child;
+
+// Updates a persistent map while keeping a snapshot every few updates,
+// then measures the memory that all versions share and lookups spread
+// over them, against a single mutable AVLMap
+void benchmarkVersions(size_t n, size_t updates, size_t versions) {
+    using Versioned = PersistentAVLMap<int, int>;
+    vector<pair<int, int>> rows(n);
+    for (size_t i = 0; i < n; i++) rows[i] = {int(2 * i), int(i)};
+    mt19937 rng(2024);
+    vector<int> keys(updates);
+    for (int &k : keys) k = int(rng() % (2 * n + 1));
+
+    Versioned map;
+    map.assignSorted(rows.begin(), rows.end());
+    AVLMap<int, int> plain;
+    plain.assignSorted(rows.begin(), rows.end());
+    size_t baseNodes = Versioned::liveNodes();
+
+    vector<Versioned> kept;
+    kept.reserve(versions + 1);
+    size_t every = max(size_t(1), updates / max(versions, size_t(1)));
+    double persistentTime = secondsFor([&] {
+        for (size_t i = 0; i < updates; i++) {
+            map.insert_or_assign(keys[i], int(i));
+            if (i % every == every - 1) kept.push_back(map);
+        }
+    });
+    double plainTime = secondsFor([&] {
+        for (size_t i = 0; i < updates; i++) plain.insert_or_assign(keys[i], int(i));
+    });
+
+    size_t liveNodes = Versioned::liveNodes();
+    double mb = 1.0 / (1 << 20);
+    double extraBytes = double(liveNodes - baseNodes) * Versioned::nodeBytes();
+    cout << n << " keys, " << updates << " updates, " << kept.size() << " versions kept\n" << fixed << setprecision(1);
+    cout << "  update    persistent " << persistentTime * 1e9 / updates << " ns, AVLMap " << plainTime * 1e9 / updates << " ns\n";
+    cout << "  memory    one version " << double(baseNodes * Versioned::nodeBytes()) * mb << " MB, all versions "
+         << double(liveNodes * Versioned::nodeBytes()) * mb << " MB, full copies would need "
+         << double(kept.size() + 1) * double(map.size() * Versioned::nodeBytes()) * mb << " MB\n";
+    cout << "  overhead  " << extraBytes / double(updates) << " bytes/update, "
+         << extraBytes / double(max(kept.size(), size_t(1))) / 1024 << " KB/version (height " << map.height() << ")\n";
+
+    vector<int> probes(1000000);
+    vector<size_t> which(probes.size());
+    for (size_t i = 0; i < probes.size(); i++) {
+        probes[i] = int(rng() % (2 * n));
+        which[i] = kept.empty() ? 0 : rng() % kept.size();
+    }
+    long found = 0;
+    double plainRead = secondsFor([&] { for (int k : probes) found += plain.contains(k); });
+    double latestRead = secondsFor([&] { for (int k : probes) found += map.contains(k); });
+    double spreadRead = secondsFor([&] {
+        for (size_t i = 0; i < probes.size(); i++) found += (kept.empty() ? map : kept[which[i]]).contains(probes[i]);
+    });
+    cout << "  lookup    AVLMap " << plainRead * 1e9 / probes.size() << " ns, latest version "
+         << latestRead * 1e9 / probes.size() << " ns, random old version " << spreadRead * 1e9 / probes.size()
+         << " ns (found " << found << ")\n";
+
+    double reclaim = secondsFor([&] { kept.clear(); });
+    cout << "  reclaim   dropping the old versions took " << setprecision(3) << reclaim << " s, "
+         << Versioned::liveNodes() << " nodes left\n";
 }
 
-Node* insert(Node*root, int key){
-    if(root == nullptr){
-        return new Node(key);
+// Startup cost of an n-key index: reread the raw keys and reinsert them,
+// reread them and bulk-build, or memory-map a saved tree file. The
+// files stay in the page cache, so this measures CPU work, not disk.
+void benchmarkStartup(size_t n, const string &dir) {
+    string inputPath = dir + "/avl_keys.bin", treePath = dir + "/avl_keys.tree";
+    {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; i++) keys[i] = int(2 * i);
+        FILE* f = fopen(inputPath.c_str(), "wb");
+        if (!f || fwrite(keys.data(), sizeof(int), n, f) != n) {
+            cout << "Cannot write " << inputPath << "\n";
+            if (f) fclose(f);
+            return;
+        }
+        fclose(f);
     }
-     else if(key < root->data){
-        root->left = insert(root->left, key);
+    auto readKeys = [&] {
+        vector<int> keys(n);
+        FILE* f = fopen(inputPath.c_str(), "rb");
+        size_t got = f ? fread(keys.data(), sizeof(int), n, f) : 0;
+        if (f) fclose(f);
+        keys.resize(got);
+        return keys;
+    };
+
+    double saveTime = 0, insertTime, bulkTime;
+    bool saved = false;
+    {
+        AVLSet<int> s;
+        insertTime = secondsFor([&] { for (int k : readKeys()) s.insert(k); });
+        saveTime = secondsFor([&] { saved = writeTreeFile<int>(treePath, s.begin(), s.end()); });
     }
-    else if(key > root->data){
-        root->right = insert(root->right, key);
+    {
+        AVLSet<int> s;
+        bulkTime = secondsFor([&] {
+            vector<int> keys = readKeys();
+            s.assignSorted(keys.begin(), keys.end());
+        });
     }
-    else{
-        return root;
+    if (!saved) {
+        cout << "Cannot write " << treePath << "\n";
+        return;
     }
 
-    // 2 is update height;
-    root->height = 1 + max(getHeight(root->left), getHeight(root->right));
-
-    // 3 get balance factor (0, 1, -1) or other
-    int balance = getFactor(root); 
-
-     // Balance the tree if needed
-
-     if(balance > 1 && key <root->left->data){
-       return rightRotation(root);
-     }
-     else if(balance <-1 && key >root->right->data){
-       return leftRotation(root);
-     }
-     else if(balance > 1 && key > root->left->data){
-        root->left = leftRotation(root->left);
-        return rightRotation(root);
-     }
-     else if(balance <-1 && key <root->right->data){
-        root->right = rightRotation(root->right);
-        return leftRotation(root);
-     }
-   
-     return root;
+    MappedTree<int> mapped;
+    bool opened = false;
+    double mapTime = secondsFor([&] { opened = mapped.open(treePath); });
+    if (!opened) {
+        cout << "Cannot map " << treePath << "\n";
+        return;
+    }
+    mt19937 rng(5);
+    vector<int> probes(1000000);
+    for (int &p : probes) p = int(rng() % (2 * n + 1));
+    long found = 0;
+    double firstQueries = secondsFor([&] { for (size_t i = 0; i < 1000; i++) found += mapped.contains(probes[i]); });
+    double lookups = secondsFor([&] { for (int p : probes) found += mapped.contains(p); });
 
+    cout << "Starting an index of " << n << " keys\n" << fixed << setprecision(3);
+    cout << "  read + insert each key " << setw(10) << insertTime << " s\n";
+    cout << "  read + assignSorted    " << setw(10) << bulkTime << " s\n";
+    cout << "  mmap tree file         " << setw(10) << mapTime << " s  (" << mapTime * 1e6
+         << " us; first 1000 lookups " << firstQueries * 1e3 << " ms)\n";
+    cout << "  saving the tree took " << saveTime << " s; mapped lookups "
+         << setprecision(1) << lookups * 1e9 / probes.size() << " ns each (found " << found << ")\n";
+    remove(inputPath.c_str());
+    remove(treePath.c_str());
 }
 
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 10000000;
+        benchmarkAgainstStdMap(n);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-build") {
+        size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100000000;
+        benchmarkBulkBuild(n);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-versions") {
+        size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000000;
+        size_t updates = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1000000;
+        size_t versions = argc > 4 ? strtoul(argv[4], nullptr, 10) : 1000;
+        benchmarkVersions(n, updates, versions);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-startup") {
+        size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100000000;
+        benchmarkStartup(n, argc > 3 ? argv[3] : ".");
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-rank") {
+        size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 10000000;
+        size_t queries = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1000000;
+        benchmarkOrderStatistics(n, max(queries, size_t(1)));
+        return 0;
+    }
+
+    AVLSet<int> tree;
+    tree.insert(10);
+    tree.insert(20);
+    tree.insert(30);
+    tree.insert(40);
+    tree.insert(50);
 
+    cout << "Inorder traversal of AVL Tree: ";
+    for (int key : tree) cout << key << " ";
+    cout << endl;
 
-void inorder(Node*root){
-    if(root){
-        inorder(root->left);
-        cout<<root->data<<" ";
-        inorder(root->right);
-    }
-}
+    tree.erase(20);
+    cout << "After erasing 20: ";
+    for (int key : tree) cout << key << " ";
+    cout << endl;
+
+    auto it = tree.lower_bound(25);
+    cout << "First key >= 25: " << (it != tree.end() ? to_string(*it) : "none") << endl;
+
+    vector<int> odds = {1, 3, 5, 7, 9};
+    AVLSet<int> other;
+    other.assignSorted(odds.begin(), odds.end());
+    cout << "Union with 1 3 5 7 9: ";
+    for (int key : AVLSet<int>::unionOf(tree, other)) cout << key << " ";
+    cout << endl;
 
+    AVLMap<string, int, std::less<string>, SumOfValues<int>> scores;
+    scores.insert_or_assign("ana", 40);
+    scores.insert_or_assign("bo", 75);
+    scores.insert_or_assign("cy", 60);
+    scores.insert_or_assign("ana", 90);
+    cout << "Second name: " << scores.select(1)->first << ", names before \"c\": " << scores.rank("c")
+         << ", score total a..c: " << scores.aggregateRange("a", "c") << endl;
 
-int main(){
-    Node*root= nullptr;
-    root = insert(root,10);
-    root = insert(root,20);
-    root = insert(root,30);
-    root = insert(root,40);
-    root = insert(root,50);
+    PersistentAVLMap<string, int> prices;
+    prices.insert("tea", 3);
+    PersistentAVLMap<string, int> before = prices;   // O(1) snapshot
+    prices.insert_or_assign("tea", 4);
+    prices.insert("jam", 5);
+    cout << "Tea was " << *before.find("tea") << ", now " << *prices.find("tea")
+         << "; the snapshot has " << before.size() << " item(s)" << endl;
 
-     cout << "Inorder traversal of AVL Tree: ";
-    inorder(root);
+    AVLMap<string, int> stock;
+    stock["apples"] = 3;
+    stock["pears"] = 7;
+    stock.insert("figs", 2);
+    cout << "Ordered map:";
+    for (auto &kv : stock) cout << " " << kv.first << "=" << kv.second;
     cout << endl;
 }
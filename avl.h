@@ -0,0 +1,775 @@
+#ifndef AVL_H
+#define AVL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Fixed-size node allocator. Nodes are carved out of large blocks and
+// recycled through a free list, so a tree pays one allocation per block
+// instead of one per key, and nodes inserted together share cache lines.
+template <class T, size_t BlockSize = 4096>
+class NodePool {
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<Slot*> blocks;
+    Slot* freeList = nullptr;
+    size_t usedInBlock = BlockSize;
+
+public:
+    NodePool() = default;
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    NodePool(NodePool &&other) noexcept { swap(other); }
+    NodePool &operator=(NodePool &&other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    // Only frees memory: owners must destroy live nodes first
+    ~NodePool() { release(); }
+
+    template <class... Args>
+    T* create(Args &&... args) {
+        Slot* s = freeList;
+        if (s) {
+            freeList = s->next;
+        } else {
+            if (usedInBlock == BlockSize) {
+                blocks.push_back(static_cast<Slot*>(::operator new(sizeof(Slot) * BlockSize)));
+                usedInBlock = 0;
+            }
+            s = blocks.back() + usedInBlock++;
+        }
+        return new (s->storage) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* p) {
+        p->~T();
+        Slot* s = reinterpret_cast<Slot*>(p);
+        s->next = freeList;
+        freeList = s;
+    }
+
+    void release() {
+        for (Slot* b : blocks) ::operator delete(b);
+        blocks.clear();
+        freeList = nullptr;
+        usedInBlock = BlockSize;
+    }
+
+    void swap(NodePool &other) noexcept {
+        blocks.swap(other.blocks);
+        std::swap(freeList, other.freeList);
+        std::swap(usedInBlock, other.usedInBlock);
+    }
+};
+
+// Aggregate policies for AVLMap. Each node caches the combination of
+// of(key, value) over its subtree, in key order, so range queries need
+// only O(log n) nodes. combine must be associative; it need not be
+// commutative or invertible (max works as well as sum).
+struct NoAggregate {
+    struct type {};
+    static type identity() { return {}; }
+    template <class K, class V>
+    static type of(const K &, const V &) { return {}; }
+    static type combine(type, type) { return {}; }
+};
+
+// Sum of the mapped values, e.g. scores in a leaderboard
+template <class T>
+struct SumOfValues {
+    using type = T;
+    static T identity() { return T(); }
+    template <class K, class V>
+    static T of(const K &, const V &v) { return T(v); }
+    static T combine(const T &a, const T &b) { return a + b; }
+};
+
+// Sum of the keys themselves, for sets
+template <class T>
+struct SumOfKeys {
+    using type = T;
+    static T identity() { return T(); }
+    template <class K, class V>
+    static T of(const K &k, const V &) { return T(k); }
+    static T combine(const T &a, const T &b) { return a + b; }
+};
+
+// Ordered map on an AVL tree. Insert and erase are iterative: they walk
+// down to the position, then walk back up through parent pointers fixing
+// heights and rotating. Iterators stay valid until their element is
+// erased, as with std::map.
+//
+// Every node also stores its subtree size and an Aggregate, kept correct
+// by rotations, inserts and erases. That gives rank, select and range
+// queries in O(log n). When the aggregate depends on values, change
+// values with insert_or_assign: writing through operator[] or an
+// iterator skips the refresh.
+template <class Key, class Value, class Compare = std::less<Key>, class Aggregate = NoAggregate>
+class AVLMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+    using size_type = size_t;
+    using aggregate_type = typename Aggregate::type;
+
+private:
+    struct Node {
+        value_type kv;
+        Node* left = nullptr;
+        Node* right = nullptr;
+        Node* parent = nullptr;
+        size_t size = 1;
+        int height = 1;
+        aggregate_type agg;
+
+        template <class K, class V>
+        Node(K &&k, V &&v, Node* p)
+            : kv(std::forward<K>(k), std::forward<V>(v)), parent(p), agg(Aggregate::of(kv.first, kv.second)) {}
+    };
+
+    Node* root = nullptr;
+    size_t count = 0;
+    Compare less;
+    NodePool<Node> pool;
+
+    static int getHeight(const Node* n) { return n ? n->height : 0; }
+
+    static int getFactor(const Node* n) { return getHeight(n->left) - getHeight(n->right); }
+
+    static size_t getSize(const Node* n) { return n ? n->size : 0; }
+
+    static aggregate_type getAgg(const Node* n) { return n ? n->agg : Aggregate::identity(); }
+
+    static constexpr bool hasAggregate = !std::is_same<Aggregate, NoAggregate>::value;
+
+    static void refreshAgg(Node* n) {
+        n->agg = Aggregate::combine(Aggregate::combine(getAgg(n->left), Aggregate::of(n->kv.first, n->kv.second)),
+                                    getAgg(n->right));
+    }
+
+    // size and aggregate from the children
+    static void refreshCounts(Node* n) {
+        n->size = 1 + getSize(n->left) + getSize(n->right);
+        refreshAgg(n);
+    }
+
+    static void refresh(Node* n) {
+        n->height = 1 + std::max(getHeight(n->left), getHeight(n->right));
+        refreshCounts(n);
+    }
+
+    static Node* leftmost(Node* n) {
+        while (n->left) n = n->left;
+        return n;
+    }
+
+    static Node* rightmost(Node* n) {
+        while (n->right) n = n->right;
+        return n;
+    }
+
+    static Node* successor(Node* n) {
+        if (n->right) return leftmost(n->right);
+        while (n->parent && n == n->parent->right) n = n->parent;
+        return n->parent;
+    }
+
+    static Node* predecessor(Node* n) {
+        if (n->left) return rightmost(n->left);
+        while (n->parent && n == n->parent->left) n = n->parent;
+        return n->parent;
+    }
+
+    void replaceChild(Node* parent, Node* old, Node* now) {
+        if (!parent) root = now;
+        else if (parent->left == old) parent->left = now;
+        else parent->right = now;
+    }
+
+    Node* leftRotation(Node* x) {
+        Node* y = x->right;
+        x->right = y->left;
+        if (y->left) y->left->parent = x;
+        y->parent = x->parent;
+        replaceChild(x->parent, x, y);
+        y->left = x;
+        x->parent = y;
+        refresh(x);
+        refresh(y);
+        return y;
+    }
+
+    Node* rightRotation(Node* x) {
+        Node* y = x->left;
+        x->left = y->right;
+        if (y->right) y->right->parent = x;
+        y->parent = x->parent;
+        replaceChild(x->parent, x, y);
+        y->right = x;
+        x->parent = y;
+        refresh(x);
+        refresh(y);
+        return y;
+    }
+
+    // Restore balance at n, returning the root of its subtree
+    Node* balance(Node* n) {
+        refresh(n);
+        int factor = getFactor(n);
+        if (factor > 1) {
+            if (getFactor(n->left) < 0) leftRotation(n->left);
+            return rightRotation(n);
+        }
+        if (factor < -1) {
+            if (getFactor(n->right) > 0) rightRotation(n->right);
+            return leftRotation(n);
+        }
+        return n;
+    }
+
+    // Walk from n to the root after a subtree gained (delta = 1) or lost
+    // (delta = -1) a node. Once a subtree keeps its old height no
+    // ancestor needs rotating, but their sizes still change.
+    void rebalanceUp(Node* n, int delta) {
+        while (n) {
+            int oldHeight = n->height;
+            n = balance(n);
+            if (n->height == oldHeight) break;
+            n = n->parent;
+        }
+        if (n) adjustUp(n->parent, delta);
+    }
+
+    // Sizes move by delta without reading the siblings, which are
+    // usually not in cache; aggregates have to be recombined
+    static void adjustUp(Node* n, int delta) {
+        for (; n; n = n->parent) {
+            n->size += size_t(delta);
+            if (hasAggregate) refreshAgg(n);
+        }
+    }
+
+    Node* lowerBoundNode(const Key &key) const {
+        Node* n = root;
+        Node* best = nullptr;
+        while (n) {
+            if (less(n->kv.first, key)) {
+                n = n->right;
+            } else {
+                best = n;
+                n = n->left;
+            }
+        }
+        return best;
+    }
+
+    Node* upperBoundNode(const Key &key) const {
+        Node* n = root;
+        Node* best = nullptr;
+        while (n) {
+            if (less(key, n->kv.first)) {
+                best = n;
+                n = n->left;
+            } else {
+                n = n->right;
+            }
+        }
+        return best;
+    }
+
+    Node* selectNode(size_t k) const {
+        Node* n = root;
+        while (n) {
+            size_t leftSize = getSize(n->left);
+            if (k < leftSize) {
+                n = n->left;
+            } else if (k == leftSize) {
+                return n;
+            } else {
+                k -= leftSize + 1;
+                n = n->right;
+            }
+        }
+        return nullptr;
+    }
+
+    Node* findNode(const Key &key) const {
+        Node* n = root;
+        while (n) {
+            // both comparisons up front so the step below becomes a
+            // conditional move instead of an unpredictable branch
+            bool goLeft = less(key, n->kv.first);
+            bool goRight = less(n->kv.first, key);
+            if (goLeft == goRight) return n;
+            n = goRight ? n->right : n->left;
+        }
+        return nullptr;
+    }
+
+    template <class K, class V>
+    std::pair<Node*, bool> insertNode(K &&key, V &&value) {
+        Node* parent = nullptr;
+        Node* n = root;
+        bool goLeft = false;
+        while (n) {
+            parent = n;
+            if (less(key, n->kv.first)) {
+                goLeft = true;
+                n = n->left;
+            } else if (less(n->kv.first, key)) {
+                goLeft = false;
+                n = n->right;
+            } else {
+                return {n, false};
+            }
+        }
+
+        Node* node = pool.create(std::forward<K>(key), std::forward<V>(value), parent);
+        if (!parent) root = node;
+        else if (goLeft) parent->left = node;
+        else parent->right = node;
+        count++;
+        rebalanceUp(parent, 1);
+        return {node, true};
+    }
+
+    void eraseNode(Node* z) {
+        Node* start;
+        if (!z->left || !z->right) {
+            Node* child = z->left ? z->left : z->right;
+            if (child) child->parent = z->parent;
+            replaceChild(z->parent, z, child);
+            start = z->parent;
+        } else {
+            // relink the successor into z's place so iterators to it stay valid
+            Node* y = leftmost(z->right);
+            if (y->parent != z) {
+                start = y->parent;
+                y->parent->left = y->right;
+                if (y->right) y->right->parent = y->parent;
+                y->right = z->right;
+                z->right->parent = y;
+            } else {
+                start = y;
+            }
+            y->left = z->left;
+            z->left->parent = y;
+            y->parent = z->parent;
+            replaceChild(z->parent, z, y);
+            y->height = z->height;
+            y->size = z->size;
+        }
+        pool.destroy(z);
+        count--;
+        rebalanceUp(start, -1);
+    }
+
+    // Balanced subtree of the next n nodes handed out by next(), which
+    // yields nodes in key order. The middle node becomes the root, so
+    // sibling heights never differ by more than one. Recursion depth is
+    // only log2(n).
+    template <class Next>
+    Node* buildSorted(size_t n, Next &next) {
+        if (n == 0) return nullptr;
+        size_t leftCount = (n - 1) / 2;
+        Node* left = buildSorted(leftCount, next);
+        Node* node = next();
+        node->left = left;
+        if (left) left->parent = node;
+        node->right = buildSorted(n - 1 - leftCount, next);
+        if (node->right) node->right->parent = node;
+        refresh(node);
+        return node;
+    }
+
+    template <class Next>
+    void assignFrom(size_t n, Next next) {
+        destroyAll();
+        root = buildSorted(n, next);
+        count = n;
+    }
+
+    // Sorted merge of a and b, keeping keys by rule(inA, inB); a's value wins on ties
+    template <class Rule>
+    static AVLMap merge(const AVLMap &a, const AVLMap &b, Rule rule) {
+        std::vector<const value_type*> merged;
+        merged.reserve(a.size() + b.size());
+        auto i = a.begin(), j = b.begin();
+        while (i != a.end() || j != b.end()) {
+            if (j == b.end() || (i != a.end() && a.less(i->first, j->first))) {
+                if (rule(true, false)) merged.push_back(&*i);
+                ++i;
+            } else if (i == a.end() || a.less(j->first, i->first)) {
+                if (rule(false, true)) merged.push_back(&*j);
+                ++j;
+            } else {
+                if (rule(true, true)) merged.push_back(&*i);
+                ++i;
+                ++j;
+            }
+        }
+
+        AVLMap out(a.less);
+        auto p = merged.begin();
+        out.assignFrom(merged.size(), [&] {
+            const value_type* kv = *p++;
+            return out.pool.create(kv->first, kv->second, nullptr);
+        });
+        return out;
+    }
+
+    void destroyAll() {
+        if (!std::is_trivially_destructible<Node>::value) {
+            // post-order walk through parent pointers, no recursion
+            Node* n = root;
+            while (n) {
+                if (n->left) {
+                    n = n->left;
+                } else if (n->right) {
+                    n = n->right;
+                } else {
+                    Node* parent = n->parent;
+                    if (parent) {
+                        if (parent->left == n) parent->left = nullptr;
+                        else parent->right = nullptr;
+                    }
+                    pool.destroy(n);
+                    n = parent;
+                }
+            }
+        }
+        pool.release();
+        root = nullptr;
+        count = 0;
+    }
+
+    template <bool Const>
+    class Iter {
+    private:
+        friend class AVLMap;
+        using TreePtr = const AVLMap*;
+        Node* node = nullptr;
+        TreePtr tree = nullptr;
+
+        Iter(Node* n, TreePtr t) : node(n), tree(t) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = AVLMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        Iter() = default;
+        // iterator -> const_iterator
+        template <bool C = Const, class = std::enable_if_t<C>>
+        Iter(const Iter<false> &other) : node(other.node), tree(other.tree) {}
+
+        reference operator*() const { return node->kv; }
+        pointer operator->() const { return &node->kv; }
+
+        Iter &operator++() {
+            node = successor(node);
+            return *this;
+        }
+        Iter operator++(int) {
+            Iter old = *this;
+            ++*this;
+            return old;
+        }
+        Iter &operator--() {
+            node = node ? predecessor(node) : rightmost(tree->root);
+            return *this;
+        }
+        Iter operator--(int) {
+            Iter old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const Iter &other) const { return node == other.node; }
+        bool operator!=(const Iter &other) const { return node != other.node; }
+
+        friend class Iter<!Const>;
+    };
+
+public:
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    AVLMap() = default;
+    explicit AVLMap(const Compare &comp) : less(comp) {}
+    AVLMap(const AVLMap &) = delete;
+    AVLMap &operator=(const AVLMap &) = delete;
+
+    AVLMap(AVLMap &&other) noexcept
+        : root(other.root), count(other.count), less(std::move(other.less)), pool(std::move(other.pool)) {
+        other.root = nullptr;
+        other.count = 0;
+    }
+
+    AVLMap &operator=(AVLMap &&other) noexcept {
+        if (this != &other) {
+            destroyAll();
+            root = other.root;
+            count = other.count;
+            less = std::move(other.less);
+            pool = std::move(other.pool);
+            other.root = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    ~AVLMap() { destroyAll(); }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int height() const { return getHeight(root); }
+    void clear() { destroyAll(); }
+
+    iterator begin() { return iterator(root ? leftmost(root) : nullptr, this); }
+    iterator end() { return iterator(nullptr, this); }
+    const_iterator begin() const { return const_iterator(root ? leftmost(root) : nullptr, this); }
+    const_iterator end() const { return const_iterator(nullptr, this); }
+
+    iterator find(const Key &key) { return iterator(findNode(key), this); }
+    const_iterator find(const Key &key) const { return const_iterator(findNode(key), this); }
+    bool contains(const Key &key) const { return findNode(key) != nullptr; }
+
+    // First element not less than key
+    iterator lower_bound(const Key &key) { return iterator(lowerBoundNode(key), this); }
+    const_iterator lower_bound(const Key &key) const { return const_iterator(lowerBoundNode(key), this); }
+
+    // First element greater than key
+    iterator upper_bound(const Key &key) { return iterator(upperBoundNode(key), this); }
+    const_iterator upper_bound(const Key &key) const { return const_iterator(upperBoundNode(key), this); }
+
+    // Inserts (key, value) unless key is present; never overwrites
+    template <class K, class V>
+    std::pair<iterator, bool> insert(K &&key, V &&value) {
+        auto r = insertNode(std::forward<K>(key), std::forward<V>(value));
+        return {iterator(r.first, this), r.second};
+    }
+
+    std::pair<iterator, bool> insert(const value_type &kv) { return insert(kv.first, kv.second); }
+
+    Value &operator[](const Key &key) { return insertNode(key, Value()).first->kv.second; }
+
+    // Inserts or overwrites, keeping aggregates over values correct
+    template <class K, class V>
+    std::pair<iterator, bool> insert_or_assign(K &&key, V &&value) {
+        if (Node* n = findNode(key)) {
+            n->kv.second = std::forward<V>(value);
+            adjustUp(n, 0);
+            return {iterator(n, this), false};
+        }
+        return insert(std::forward<K>(key), std::forward<V>(value));
+    }
+
+    // Number of keys less than key
+    size_t rank(const Key &key) const {
+        size_t r = 0;
+        Node* n = root;
+        while (n) {
+            if (less(n->kv.first, key)) {
+                r += getSize(n->left) + 1;
+                n = n->right;
+            } else {
+                n = n->left;
+            }
+        }
+        return r;
+    }
+
+    // The k-th smallest element (from 0), or end()
+    iterator select(size_t k) { return iterator(selectNode(k), this); }
+    const_iterator select(size_t k) const { return const_iterator(selectNode(k), this); }
+
+    // Number of keys in [lo, hi)
+    size_t countRange(const Key &lo, const Key &hi) const {
+        size_t a = rank(lo), b = rank(hi);
+        return b > a ? b - a : 0;
+    }
+
+    aggregate_type aggregate() const { return getAgg(root); }
+
+    // Aggregate of the keys in [lo, hi), combined in key order
+    aggregate_type aggregateRange(const Key &lo, const Key &hi) const {
+        // the highest node inside the range; everything else in the range
+        // lies on the two paths below it
+        Node* n = root;
+        while (n) {
+            if (less(n->kv.first, lo)) n = n->right;
+            else if (!less(n->kv.first, hi)) n = n->left;
+            else break;
+        }
+        if (!n) return Aggregate::identity();
+
+        // left path: keys >= lo, met in decreasing order
+        aggregate_type left = Aggregate::identity();
+        for (Node* m = n->left; m;) {
+            if (less(m->kv.first, lo)) {
+                m = m->right;
+            } else {
+                left = Aggregate::combine(Aggregate::combine(Aggregate::of(m->kv.first, m->kv.second), getAgg(m->right)), left);
+                m = m->left;
+            }
+        }
+        // right path: keys < hi, met in increasing order
+        aggregate_type right = Aggregate::identity();
+        for (Node* m = n->right; m;) {
+            if (less(m->kv.first, hi)) {
+                right = Aggregate::combine(right, Aggregate::combine(getAgg(m->left), Aggregate::of(m->kv.first, m->kv.second)));
+                m = m->right;
+            } else {
+                m = m->left;
+            }
+        }
+        return Aggregate::combine(Aggregate::combine(left, Aggregate::of(n->kv.first, n->kv.second)), right);
+    }
+
+    // Replaces the contents with [first, last) in O(n). The range must hold
+    // (key, value) pairs sorted by key with no duplicates.
+    template <class It>
+    void assignSorted(It first, It last) {
+        assignFrom(size_t(std::distance(first, last)), [&] {
+            Node* node = pool.create(first->first, first->second, nullptr);
+            ++first;
+            return node;
+        });
+    }
+
+    // Same as assignSorted for a range of keys; values are default-constructed
+    template <class It>
+    void assignSortedKeys(It first, It last) {
+        assignFrom(size_t(std::distance(first, last)), [&] {
+            Node* node = pool.create(*first, Value(), nullptr);
+            ++first;
+            return node;
+        });
+    }
+
+    // Keys in a or b, in O(|a| + |b|); a's value wins for keys in both
+    static AVLMap unionOf(const AVLMap &a, const AVLMap &b) {
+        return merge(a, b, [](bool inA, bool inB) { return inA || inB; });
+    }
+
+    // Keys in both a and b, in O(|a| + |b|), with a's values
+    static AVLMap intersectionOf(const AVLMap &a, const AVLMap &b) {
+        return merge(a, b, [](bool inA, bool inB) { return inA && inB; });
+    }
+
+    size_t erase(const Key &key) {
+        Node* n = findNode(key);
+        if (!n) return 0;
+        eraseNode(n);
+        return 1;
+    }
+
+    iterator erase(iterator pos) {
+        Node* next = successor(pos.node);
+        eraseNode(pos.node);
+        return iterator(next, this);
+    }
+};
+
+// Ordered set: an AVLMap without mapped values
+template <class Key, class Compare = std::less<Key>, class Aggregate = NoAggregate>
+class AVLSet {
+private:
+    struct Empty {};
+    using Map = AVLMap<Key, Empty, Compare, Aggregate>;
+    Map map;
+
+public:
+    class const_iterator {
+    private:
+        friend class AVLSet;
+        typename Map::const_iterator it;
+        explicit const_iterator(typename Map::const_iterator i) : it(i) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Key;
+        using difference_type = std::ptrdiff_t;
+        using reference = const Key &;
+        using pointer = const Key*;
+
+        const_iterator() = default;
+        reference operator*() const { return it->first; }
+        pointer operator->() const { return &it->first; }
+        const_iterator &operator++() { ++it; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++it; return old; }
+        const_iterator &operator--() { --it; return *this; }
+        const_iterator operator--(int) { const_iterator old = *this; --it; return old; }
+        bool operator==(const const_iterator &other) const { return it == other.it; }
+        bool operator!=(const const_iterator &other) const { return it != other.it; }
+    };
+    using iterator = const_iterator;
+
+    AVLSet() = default;
+    explicit AVLSet(const Compare &comp) : map(comp) {}
+
+    size_t size() const { return map.size(); }
+    bool empty() const { return map.empty(); }
+    int height() const { return map.height(); }
+    void clear() { map.clear(); }
+
+    const_iterator begin() const { return const_iterator(map.begin()); }
+    const_iterator end() const { return const_iterator(map.end()); }
+    const_iterator find(const Key &key) const { return const_iterator(map.find(key)); }
+    const_iterator lower_bound(const Key &key) const { return const_iterator(map.lower_bound(key)); }
+    const_iterator upper_bound(const Key &key) const { return const_iterator(map.upper_bound(key)); }
+    bool contains(const Key &key) const { return map.contains(key); }
+
+    size_t rank(const Key &key) const { return map.rank(key); }
+    const_iterator select(size_t k) const { return const_iterator(map.select(k)); }
+    size_t countRange(const Key &lo, const Key &hi) const { return map.countRange(lo, hi); }
+    typename Map::aggregate_type aggregate() const { return map.aggregate(); }
+    typename Map::aggregate_type aggregateRange(const Key &lo, const Key &hi) const {
+        return map.aggregateRange(lo, hi);
+    }
+
+    std::pair<const_iterator, bool> insert(const Key &key) {
+        auto r = map.insert(key, Empty());
+        return {const_iterator(r.first), r.second};
+    }
+
+    // Replaces the contents with sorted, duplicate-free keys in O(n)
+    template <class It>
+    void assignSorted(It first, It last) { map.assignSortedKeys(first, last); }
+
+    static AVLSet unionOf(const AVLSet &a, const AVLSet &b) {
+        AVLSet out;
+        out.map = Map::unionOf(a.map, b.map);
+        return out;
+    }
+
+    static AVLSet intersectionOf(const AVLSet &a, const AVLSet &b) {
+        AVLSet out;
+        out.map = Map::intersectionOf(a.map, b.map);
+        return out;
+    }
+
+    size_t erase(const Key &key) { return map.erase(key); }
+};
+
+#endif
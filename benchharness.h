@@ -0,0 +1,253 @@
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Shared micro-benchmark harness. A benchmark is a body that performs a
+// known number of operations per call. The harness calibrates a batch
+// of calls that lasts about one sample period, times a series of such
+// samples, and reports the mean cost per operation, the throughput, the
+// 50th/90th/99th percentiles of the per-sample cost, and the heap
+// allocations per operation. Percentiles are taken over samples, not
+// single calls: a call that takes a few nanoseconds cannot be timed on
+// its own, so they show run-to-run jitter rather than tail latency.
+//
+// Allocations are counted only when the program replaces the global
+// operator new and bumps the counters below (benchmarks.cpp does);
+// otherwise they read 0.
+
+inline std::atomic<uint64_t> benchAllocations{0};
+inline std::atomic<uint64_t> benchAllocatedBytes{0};
+
+// Keeps the compiler from discarding a result that is never used
+template <class T>
+inline void keepValue(const T &value) {
+    asm volatile("" : : "m"(value) : "memory");
+}
+
+// Stream buffer that drops everything, for timing code that prints
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// Sends a stream to a NullBuffer while in scope
+class SilenceStream {
+private:
+    std::ostream &os;
+    std::streambuf* saved;
+    NullBuffer sink;
+
+public:
+    explicit SilenceStream(std::ostream &s) : os(s), saved(s.rdbuf(&sink)) {}
+    SilenceStream(const SilenceStream &) = delete;
+    SilenceStream &operator=(const SilenceStream &) = delete;
+    ~SilenceStream() { os.rdbuf(saved); }
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t opsPerCall = 1;
+    uint64_t calls = 0;        // timed calls over all samples
+    size_t samples = 0;
+    double nsPerOp = 0;        // total time / total operations
+    double opsPerSecond = 0;
+    double p50 = 0, p90 = 0, p99 = 0;   // ns per operation, over samples
+    double allocsPerOp = 0;
+    double bytesPerOp = 0;
+};
+
+struct BenchOptions {
+    double sampleSeconds = 0.01;   // target length of one sample
+    size_t samples = 30;           // samples per benchmark, at most
+    double maxSeconds = 1.0;       // time budget per benchmark
+    std::string filter;            // run only names containing this
+};
+
+class BenchSuite {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    BenchOptions options;
+    std::vector<BenchResult> results;
+
+    static double since(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Nearest-rank percentile of sorted values
+    static double percentile(const std::vector<double> &sorted, double p) {
+        size_t rank = size_t(p / 100 * double(sorted.size()) + 0.999999);
+        return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+    }
+
+    // Collects samples until the count or the time budget runs out.
+    // sample() returns (seconds in the timed part, calls made).
+    template <class Sample>
+    void measure(const std::string &name, uint64_t opsPerCall, Sample sample) {
+        BenchResult r;
+        r.name = name;
+        r.opsPerCall = opsPerCall;
+        std::vector<double> perOp;
+        perOp.reserve(options.samples);   // so the harness itself allocates nothing below
+        double total = 0;
+        uint64_t allocs = benchAllocations.load(std::memory_order_relaxed);
+        uint64_t bytes = benchAllocatedBytes.load(std::memory_order_relaxed);
+        auto start = Clock::now();
+        while (perOp.size() < options.samples && (perOp.empty() || since(start) < options.maxSeconds)) {
+            std::pair<double, uint64_t> s = sample();
+            perOp.push_back(s.first * 1e9 / double(s.second * opsPerCall));
+            total += s.first;
+            r.calls += s.second;
+        }
+        allocs = benchAllocations.load(std::memory_order_relaxed) - allocs;
+        bytes = benchAllocatedBytes.load(std::memory_order_relaxed) - bytes;
+
+        double ops = double(r.calls * opsPerCall);
+        std::sort(perOp.begin(), perOp.end());
+        r.samples = perOp.size();
+        r.nsPerOp = total * 1e9 / ops;
+        r.opsPerSecond = total > 0 ? ops / total : 0;
+        r.p50 = percentile(perOp, 50);
+        r.p90 = percentile(perOp, 90);
+        r.p99 = percentile(perOp, 99);
+        r.allocsPerOp = double(allocs) / ops;
+        r.bytesPerOp = double(bytes) / ops;
+        results.push_back(r);
+        printRow(std::cout, r);
+    }
+
+    static std::string escapeJson(const std::string &s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            if ((unsigned char)c < 0x20) continue;
+            out += c;
+        }
+        return out;
+    }
+
+public:
+    explicit BenchSuite(const BenchOptions &opts = BenchOptions()) : options(opts) {}
+
+    bool selected(const std::string &name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    const std::vector<BenchResult> &all() const { return results; }
+
+    // body() performs opsPerCall operations and may be called any number
+    // of times. Calls are batched so each sample lasts sampleSeconds.
+    template <class F>
+    void run(const std::string &name, uint64_t opsPerCall, F body) {
+        if (!selected(name)) return;
+        auto start = Clock::now();
+        body();   // warm-up, and a first estimate of the cost
+        double once = std::max(since(start), 1e-9);
+        uint64_t batch = uint64_t(std::min(std::max(options.sampleSeconds / once, 1.0), 1e9));
+        measure(name, opsPerCall, [&] {
+            auto t = Clock::now();
+            for (uint64_t i = 0; i < batch; i++) body();
+            return std::make_pair(since(t), batch);
+        });
+    }
+
+    // For bodies that consume their input, such as a sort: setup() runs
+    // untimed before every call, so each sample is a single call.
+    template <class Setup, class F>
+    void run(const std::string &name, uint64_t opsPerCall, Setup setup, F body) {
+        if (!selected(name)) return;
+        setup();
+        body();   // warm-up
+        measure(name, opsPerCall, [&] {
+            setup();
+            auto t = Clock::now();
+            body();
+            return std::make_pair(since(t), uint64_t(1));
+        });
+    }
+
+    static void printHeader(std::ostream &os) {
+        os << std::left << std::setw(40) << "benchmark" << std::right << std::setw(12) << "ns/op"
+           << std::setw(14) << "ops/s" << std::setw(13) << "p50" << std::setw(13) << "p90"
+           << std::setw(13) << "p99" << std::setw(10) << "allocs/op" << std::setw(10) << "B/op" << "\n";
+    }
+
+    static void printRow(std::ostream &os, const BenchResult &r) {
+        os << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(2)
+           << std::setw(12) << r.nsPerOp << std::setprecision(0) << std::setw(14) << r.opsPerSecond
+           << std::setprecision(2) << std::setw(13) << r.p50 << std::setw(13) << r.p90 << std::setw(13) << r.p99
+           << std::setprecision(3) << std::setw(10) << r.allocsPerOp << std::setprecision(1) << std::setw(10)
+           << r.bytesPerOp << "\n";
+    }
+
+    // One result per line, so files diff cleanly and readJson can scan them
+    bool writeJson(const std::string &path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "{\n  \"time\": " << std::chrono::duration_cast<std::chrono::seconds>(
+                                        std::chrono::system_clock::now().time_since_epoch()).count()
+            << ",\n  \"compiler\": \"" << escapeJson(__VERSION__) << "\",\n  \"results\": [\n";
+        out << std::setprecision(17);
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult &r = results[i];
+            out << "    {\"name\": \"" << escapeJson(r.name) << "\", \"ns_per_op\": " << r.nsPerOp
+                << ", \"ops_per_sec\": " << r.opsPerSecond << ", \"p50_ns\": " << r.p50
+                << ", \"p90_ns\": " << r.p90 << ", \"p99_ns\": " << r.p99
+                << ", \"allocs_per_op\": " << r.allocsPerOp << ", \"bytes_per_op\": " << r.bytesPerOp
+                << ", \"ops_per_call\": " << r.opsPerCall << ", \"calls\": " << r.calls
+                << ", \"samples\": " << r.samples << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return bool(out);
+    }
+
+    // Reads name -> ns_per_op back from a file written by writeJson. Not
+    // a general JSON parser.
+    static bool readJson(const std::string &path, std::map<std::string, double> &nsPerOp) {
+        std::ifstream in(path);
+        if (!in) return false;
+        std::string line;
+        const std::string nameKey = "\"name\": \"", nsKey = "\"ns_per_op\": ";
+        while (std::getline(in, line)) {
+            size_t n = line.find(nameKey), t = line.find(nsKey);
+            if (n == std::string::npos || t == std::string::npos) continue;
+            std::string name;
+            for (size_t i = n + nameKey.size(); i < line.size() && line[i] != '"'; i++) {
+                if (line[i] == '\\' && i + 1 < line.size()) i++;
+                name += line[i];
+            }
+            nsPerOp[name] = std::strtod(line.c_str() + t + nsKey.size(), nullptr);
+        }
+        return true;
+    }
+
+    // Change in ns/op against an earlier run; positive means slower
+    void printComparison(std::ostream &os, const std::map<std::string, double> &baseline) const {
+        os << std::left << std::setw(40) << "benchmark" << std::right << std::setw(12) << "before"
+           << std::setw(12) << "after" << std::setw(10) << "change" << "\n";
+        for (const BenchResult &r : results) {
+            auto it = baseline.find(r.name);
+            if (it == baseline.end() || it->second <= 0) continue;
+            double change = (r.nsPerOp / it->second - 1) * 100;
+            os << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(2)
+               << std::setw(12) << it->second << std::setw(12) << r.nsPerOp << std::showpos << std::setprecision(1)
+               << std::setw(9) << change << "%" << std::noshowpos << "\n";
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,290 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <map>
+#include "benchharness.h"
+#include "route.h"
+#include "financetracker.h"
+#include "expression.h"
+#include "avl.h"
+#include "bts.h"
+#include "traversal.h"
+#include "numeric.h"
+using namespace std;
+
+// Benchmark suite for the hot paths of the other programs, as a program
+// of its own: g++ -std=c++17 -O2 -pthread benchmarks.cpp -o benchmarks
+//
+//   benchmarks [--filter text] [--json out.json] [--baseline old.json]
+//              [--quick] [--dir path]
+//
+// --json saves the results, --baseline prints the change against a file
+// saved earlier, --quick shortens every benchmark for smoke runs.
+
+// Every heap allocation goes through here, so the harness can count them.
+// Kept out of line so GCC does not pair the inlined malloc and free with
+// new and delete and warn about a mismatch.
+__attribute__((noinline)) void* operator new(size_t bytes) {
+    benchAllocations.fetch_add(1, memory_order_relaxed);
+    benchAllocatedBytes.fetch_add(bytes, memory_order_relaxed);
+    if (void* p = malloc(bytes ? bytes : 1)) return p;
+    throw bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+
+string stationName(size_t i) {
+    char buf[24];
+    snprintf(buf, sizeof buf, "S%05zu", i);
+    return buf;
+}
+
+void benchmarkRoute(BenchSuite &suite, size_t stations) {
+    Route linear, circular;
+    vector<string> names(stations);
+    for (size_t i = 0; i < stations; i++) {
+        names[i] = stationName(i);
+        linear.addStationEnd(names[i]);
+        circular.addStationEnd(names[i]);
+    }
+    circular.setCircular(true);
+
+    mt19937 rng(3);
+    vector<size_t> picks(1024);
+    for (size_t &p : picks) p = rng() % stations;
+    string n = to_string(stations);
+
+    size_t i = 0;
+    suite.run("route/findStationPtr hit (" + n + ")", 1, [&] {
+        keepValue(linear.findStationPtr(names[picks[i++ & 1023]]));
+    });
+    suite.run("route/findStationPtr miss (" + n + ")", 1, [&] {
+        keepValue(linear.findStationPtr("nowhere"));
+    });
+    suite.run("route/travelBetween linear (" + n + ")", 1, [&] {
+        SilenceStream quiet(cout);
+        linear.travelBetween(names[picks[i & 1023]], names[picks[(i + 1) & 1023]]);
+        i++;
+    });
+    suite.run("route/travelBetween circular (" + n + ")", 1, [&] {
+        SilenceStream quiet(cout);
+        circular.travelBetween(names[picks[i & 1023]], names[picks[(i + 1) & 1023]]);
+        i++;
+    });
+}
+
+void benchmarkFinance(BenchSuite &suite, size_t rows, const string &dir) {
+    mt19937 rng(5);
+    FinanceTracker generated;
+    for (size_t i = 0; i < rows; i++) {
+        char date[16];
+        snprintf(date, sizeof date, "2024-%02u-%02u", unsigned(rng() % 12 + 1), unsigned(rng() % 28 + 1));
+        Transaction t;
+        t.date = date;
+        t.type = rng() % 4 ? "Expense" : "Income";
+        t.description = "item " + to_string(rng() % 500);
+        t.amount = float(rng() % 100000) / 100;
+        generated.addTransaction(t);
+    }
+    string path = dir + "/bench_finance.dat";
+    {
+        SilenceStream quiet(cout);
+        generated.saveToFile(path);
+    }
+    string n = to_string(rows);
+
+    FinanceTracker loaded;
+    string name = "finance/loadFromFile (" + n + " rows)";
+    suite.run(name, rows, [&] {
+        SilenceStream quiet(cout);
+        loaded.loadFromFile(path);
+    });
+    if (suite.selected(name) && loaded.size() != rows) cout << "  MISMATCH: loaded " << loaded.size() << " rows\n";
+    suite.run("finance/monthlyReport (" + n + " rows)", rows, [&] {
+        SilenceStream quiet(cout);
+        generated.monthlyReport();
+    });
+    suite.run("finance/searchTransactions (" + n + " rows)", rows, [&] {
+        SilenceStream quiet(cout);
+        generated.searchTransactions(995.0f);
+    });
+    FinanceTracker sorting;
+    suite.run("finance/sortTransactions (" + n + " rows)", rows,
+              [&] { sorting = generated; },
+              [&] {
+                  SilenceStream quiet(cout);
+                  sorting.sortTransactions();
+              });
+    remove(path.c_str());
+}
+
+string randomInfix(mt19937 &rng, int depth) {
+    if (depth == 0 || rng() % 4 == 0) {
+        if (rng() % 3 == 0) return string(1, char('a' + rng() % 26));
+        return to_string(rng() % 1000) + (rng() % 2 ? ".5" : "");
+    }
+    static const char ops[] = "+-*/^";
+    char op = ops[rng() % (rng() % 8 == 0 ? 5 : 4)];
+    string e = randomInfix(rng, depth - 1) + op + randomInfix(rng, depth - 1);
+    return rng() % 2 ? "(" + e + ")" : e;
+}
+
+void benchmarkExpressions(BenchSuite &suite) {
+    mt19937 rng(11);
+    vector<string> infix(256), postfix(256);
+    size_t bytes = 0;
+    for (size_t i = 0; i < infix.size(); i++) {
+        infix[i] = randomInfix(rng, 5);
+        postfix[i] = infixToPostfix(infix[i]);
+        bytes += infix[i].size();
+    }
+    double vars[26];
+    for (int v = 0; v < 26; v++) vars[v] = v + 1.5;
+
+    suite.run("expr/infixToPostfix (" + to_string(bytes / infix.size()) + " chars)", infix.size(), [&] {
+        for (const string &e : infix) keepValue(infixToPostfix(e));
+    });
+    suite.run("expr/evaluatePostfix", postfix.size(), [&] {
+        double sum = 0;
+        for (const string &e : postfix) sum += evaluatePostfix(e, vars);
+        keepValue(sum);
+    });
+}
+
+void benchmarkTrees(BenchSuite &suite, size_t n) {
+    vector<int> keys(n);
+    iota(keys.begin(), keys.end(), 0);
+    shuffle(keys.begin(), keys.end(), mt19937(7));
+    string count = " (" + to_string(n) + ")";
+
+    AVLSet<int> avl;
+    suite.run("avl/insert random" + count, n, [&] { avl.clear(); }, [&] {
+        for (int k : keys) avl.insert(k);
+    });
+    size_t i = 0;
+    suite.run("avl/contains hit" + count, 1, [&] { keepValue(avl.contains(keys[i++ % n])); });
+    suite.run("avl/inorder iterator" + count, n, [&] {
+        long long sum = 0;
+        for (int k : avl) sum += k;
+        keepValue(sum);
+    });
+
+    Node* bst = nullptr;
+    suite.run("bst/insert random" + count, n,
+              [&] {
+                  destroyTree(bst);
+                  bst = nullptr;
+              },
+              [&] {
+                  for (int k : keys) bst = insert(bst, k);
+              });
+    suite.run("bst/find hit" + count, 1, [&] { keepValue(find(bst, keys[i++ % n])); });
+    suite.run("bst/inorderIterative" + count, n, [&] {
+        long long sum = 0;
+        inorderIterative(bst, [&](Node* p) { sum += p->data; });
+        keepValue(sum);
+    });
+    suite.run("bst/morrisInorder" + count, n, [&] {
+        long long sum = 0;
+        morrisInorder(bst, [&](Node* p) { sum += p->data; });
+        keepValue(sum);
+    });
+    destroyTree(bst);
+}
+
+void benchmarkNumeric(BenchSuite &suite, uint64_t fibN, uint64_t factN, size_t pairs) {
+    unsigned k = 0;
+    suite.run("fib/fibonacci64", 1, [&] { keepValue(fibonacci64(k++ % 94)); });
+    suite.run("fib/fibonacci (n=" + to_string(fibN) + ")", 1, [&] { keepValue(fibonacci(fibN)); });
+    suite.run("fact/factorial 1 thread (n=" + to_string(factN) + ")", 1, [&] { keepValue(factorial(factN, 1)); });
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    suite.run("fact/factorial all threads (n=" + to_string(factN) + ")", 1,
+              [&] { keepValue(factorial(factN, threads)); });
+
+    mt19937_64 rng(13);
+    vector<uint64_t> a64(pairs), b64(pairs);
+    vector<uint32_t> a32(pairs), b32(pairs), out32(pairs);
+    for (size_t i = 0; i < pairs; i++) {
+        a64[i] = rng();
+        b64[i] = rng();
+        a32[i] = uint32_t(rng());
+        b32[i] = uint32_t(rng());
+    }
+    suite.run("gcd/std::gcd 64-bit", pairs, [&] {
+        uint64_t s = 0;
+        for (size_t i = 0; i < pairs; i++) s += gcd(a64[i], b64[i]);
+        keepValue(s);
+    });
+    suite.run("gcd/binaryGcd 64-bit", pairs, [&] {
+        uint64_t s = 0;
+        for (size_t i = 0; i < pairs; i++) s += binaryGcd(a64[i], b64[i]);
+        keepValue(s);
+    });
+    suite.run("gcd/binaryGcd 32-bit", pairs, [&] {
+        uint64_t s = 0;
+        for (size_t i = 0; i < pairs; i++) s += binaryGcd(a32[i], b32[i]);
+        keepValue(s);
+    });
+    suite.run("gcd/gcdBatch 32-bit", pairs, [&] {
+        gcdBatch(a32.data(), b32.data(), out32.data(), pairs);
+        keepValue(out32[0]);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    string jsonPath, baselinePath, dir = ".";
+    bool quick = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--dir" && hasValue) dir = argv[++i];
+        else if (arg == "--quick") quick = true;
+        else {
+            cout << "Usage: " << argv[0]
+                 << " [--filter text] [--json out.json] [--baseline old.json] [--quick] [--dir path]\n";
+            return 1;
+        }
+    }
+    if (quick) {
+        options.samples = 5;
+        options.maxSeconds = 0.1;
+        options.sampleSeconds = 0.002;
+    }
+
+    map<string, double> baseline;
+    if (!baselinePath.empty() && !BenchSuite::readJson(baselinePath, baseline)) {
+        cout << "Cannot read " << baselinePath << "\n";
+        return 1;
+    }
+
+    BenchSuite suite(options);
+    BenchSuite::printHeader(cout);
+    benchmarkRoute(suite, quick ? 200 : 2000);
+    benchmarkFinance(suite, quick ? 10000 : 100000, dir);
+    benchmarkExpressions(suite);
+    benchmarkTrees(suite, quick ? 10000 : 100000);
+    benchmarkNumeric(suite, quick ? 10000 : 100000, quick ? 2000 : 20000, quick ? 10000 : 100000);
+
+    if (!baseline.empty()) {
+        cout << "\n";
+        suite.printComparison(cout, baseline);
+    }
+    if (!jsonPath.empty()) {
+        if (!suite.writeJson(jsonPath)) {
+            cout << "Cannot write " << jsonPath << "\n";
+            return 1;
+        }
+        cout << "Results written to " << jsonPath << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,279 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Arbitrary-precision signed integer: a sign and a magnitude of 64-bit
+// limbs, least significant first, with no leading zero limbs (zero has
+// no limbs). Products of two large numbers switch from the schoolbook
+// method to Karatsuba, which needs three half-size products instead of
+// four and so costs O(n^1.585) instead of O(n^2).
+class BigInt {
+public:
+    using Limb = uint64_t;
+
+private:
+    using Wide = unsigned __int128;
+    static constexpr size_t KaratsubaLimbs = 32;   // below this, schoolbook wins
+
+    std::vector<Limb> mag;
+    bool negative = false;
+
+    static void trim(std::vector<Limb> &v) {
+        while (!v.empty() && v.back() == 0) v.pop_back();
+    }
+
+    static int compareMag(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        if (na != nb) return na < nb ? -1 : 1;
+        for (size_t i = na; i-- > 0;) {
+            if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static std::vector<Limb> addMag(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        if (na < nb) {
+            std::swap(a, b);
+            std::swap(na, nb);
+        }
+        std::vector<Limb> out(na + 1);
+        Limb carry = 0;
+        for (size_t i = 0; i < na; i++) {
+            Wide s = Wide(a[i]) + (i < nb ? b[i] : 0) + carry;
+            out[i] = Limb(s);
+            carry = Limb(s >> 64);
+        }
+        out[na] = carry;
+        trim(out);
+        return out;
+    }
+
+    // a - b, where a >= b
+    static std::vector<Limb> subMag(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        std::vector<Limb> out(na);
+        Limb borrow = 0;
+        for (size_t i = 0; i < na; i++) {
+            Limb bi = i < nb ? b[i] : 0;
+            Limb d = a[i] - bi - borrow;
+            borrow = (a[i] < bi) || (a[i] - bi < borrow);
+            out[i] = d;
+        }
+        trim(out);
+        return out;
+    }
+
+    // out[shift..] += v
+    static void addInto(std::vector<Limb> &out, const std::vector<Limb> &v, size_t shift) {
+        Limb carry = 0;
+        size_t i = 0;
+        for (; i < v.size(); i++) {
+            Wide s = Wide(out[shift + i]) + v[i] + carry;
+            out[shift + i] = Limb(s);
+            carry = Limb(s >> 64);
+        }
+        for (size_t j = shift + i; carry; j++) {
+            out[j] += 1;
+            carry = out[j] == 0;
+        }
+    }
+
+    static std::vector<Limb> mulSchool(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        std::vector<Limb> out(na + nb);
+        for (size_t i = 0; i < na; i++) {
+            Limb carry = 0;
+            for (size_t j = 0; j < nb; j++) {
+                Wide p = Wide(a[i]) * b[j] + out[i + j] + carry;
+                out[i + j] = Limb(p);
+                carry = Limb(p >> 64);
+            }
+            out[i + nb] = carry;
+        }
+        trim(out);
+        return out;
+    }
+
+    static std::vector<Limb> mulMag(const Limb* a, size_t na, const Limb* b, size_t nb) {
+        if (na < nb) {
+            std::swap(a, b);
+            std::swap(na, nb);
+        }
+        if (nb == 0) return {};
+        if (nb < KaratsubaLimbs) return mulSchool(a, na, b, nb);
+
+        std::vector<Limb> out(na + nb + 1);
+        if (2 * nb <= na) {
+            // lopsided: multiply b by nb-limb slices of a
+            for (size_t i = 0; i < na; i += nb) {
+                size_t len = std::min(nb, na - i);
+                addInto(out, mulMag(a + i, len, b, nb), i);
+            }
+        } else {
+            // a = a1 B^m + a0, b = b1 B^m + b0
+            size_t m = na / 2;
+            size_t na0 = m, nb0 = std::min(m, nb);
+            while (na0 && a[na0 - 1] == 0) na0--;
+            while (nb0 && b[nb0 - 1] == 0) nb0--;
+            std::vector<Limb> z0 = mulMag(a, na0, b, nb0);
+            std::vector<Limb> z2 = mulMag(a + m, na - m, b + m, nb - m);
+            std::vector<Limb> sa = addMag(a, na0, a + m, na - m);
+            std::vector<Limb> sb = addMag(b, nb0, b + m, nb - m);
+            std::vector<Limb> z1 = mulMag(sa.data(), sa.size(), sb.data(), sb.size());
+            z1 = subMag(z1.data(), z1.size(), z0.data(), z0.size());
+            z1 = subMag(z1.data(), z1.size(), z2.data(), z2.size());
+            addInto(out, z0, 0);
+            addInto(out, z1, m);
+            addInto(out, z2, 2 * m);
+        }
+        trim(out);
+        return out;
+    }
+
+    // Signed sum of (this) and (other with sign flipped when subtract).
+    // Works in place unless |other| > |this| on a subtraction, so a
+    // running sum does not reallocate on every step.
+    void addSigned(const BigInt &other, bool subtract) {
+        bool otherNegative = other.negative != subtract && !other.mag.empty();
+        size_t nb = other.mag.size();
+        if (negative == otherNegative) {
+            if (mag.size() < nb) mag.resize(nb, 0);
+            const Limb* b = other.mag.data();   // after the resize: other may be *this
+            Limb carry = 0;
+            size_t i = 0;
+            for (; i < nb; i++) {
+                Wide sum = Wide(mag[i]) + b[i] + carry;
+                mag[i] = Limb(sum);
+                carry = Limb(sum >> 64);
+            }
+            for (; carry && i < mag.size(); i++) carry = ++mag[i] == 0;
+            if (carry) mag.push_back(1);
+        } else if (compareMag(mag.data(), mag.size(), other.mag.data(), nb) >= 0) {
+            const Limb* b = other.mag.data();
+            Limb borrow = 0;
+            size_t i = 0;
+            for (; i < nb; i++) {
+                Limb a = mag[i];
+                mag[i] = a - b[i] - borrow;
+                borrow = (a < b[i]) || (a - b[i] < borrow);
+            }
+            for (; borrow; i++) borrow = mag[i]-- == 0;
+            trim(mag);
+        } else {
+            mag = subMag(other.mag.data(), other.mag.size(), mag.data(), mag.size());
+            negative = otherNegative;
+        }
+        if (mag.empty()) negative = false;
+    }
+
+public:
+    BigInt() = default;
+    BigInt(long long v) : negative(v < 0) {
+        Limb m = v < 0 ? Limb(0) - Limb(v) : Limb(v);
+        if (m) mag.push_back(m);
+    }
+    static BigInt fromUnsigned(uint64_t v) {
+        BigInt r;
+        if (v) r.mag.push_back(v);
+        return r;
+    }
+
+    bool isZero() const { return mag.empty(); }
+    bool isNegative() const { return negative; }
+    size_t limbCount() const { return mag.size(); }
+    const std::vector<Limb> &limbs() const { return mag; }
+
+    size_t bitLength() const {
+        if (mag.empty()) return 0;
+        return 64 * (mag.size() - 1) + size_t(64 - __builtin_clzll(mag.back()));
+    }
+
+    BigInt &operator+=(const BigInt &other) {
+        addSigned(other, false);
+        return *this;
+    }
+    BigInt &operator-=(const BigInt &other) {
+        addSigned(other, true);
+        return *this;
+    }
+    BigInt &operator*=(const BigInt &other) {
+        mag = mulMag(mag.data(), mag.size(), other.mag.data(), other.mag.size());
+        negative = !mag.empty() && negative != other.negative;
+        return *this;
+    }
+
+    // In-place multiply by one unsigned limb, O(n)
+    BigInt &mulSmall(Limb m) {
+        Limb carry = 0;
+        for (Limb &x : mag) {
+            Wide p = Wide(x) * m + carry;
+            x = Limb(p);
+            carry = Limb(p >> 64);
+        }
+        if (carry) mag.push_back(carry);
+        if (m == 0) {
+            mag.clear();
+            negative = false;
+        }
+        return *this;
+    }
+
+    friend BigInt operator+(BigInt a, const BigInt &b) { return a += b; }
+    friend BigInt operator-(BigInt a, const BigInt &b) { return a -= b; }
+    friend BigInt operator*(const BigInt &a, const BigInt &b) {
+        BigInt r;
+        r.mag = mulMag(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+        r.negative = !r.mag.empty() && a.negative != b.negative;
+        return r;
+    }
+
+    BigInt operator-() const {
+        BigInt r = *this;
+        if (!r.mag.empty()) r.negative = !r.negative;
+        return r;
+    }
+
+    friend int compare(const BigInt &a, const BigInt &b) {
+        if (a.negative != b.negative) return a.negative ? -1 : 1;
+        int c = compareMag(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+        return a.negative ? -c : c;
+    }
+    friend bool operator==(const BigInt &a, const BigInt &b) { return a.negative == b.negative && a.mag == b.mag; }
+    friend bool operator!=(const BigInt &a, const BigInt &b) { return !(a == b); }
+    friend bool operator<(const BigInt &a, const BigInt &b) { return compare(a, b) < 0; }
+    friend bool operator>(const BigInt &a, const BigInt &b) { return compare(a, b) > 0; }
+    friend bool operator<=(const BigInt &a, const BigInt &b) { return compare(a, b) <= 0; }
+    friend bool operator>=(const BigInt &a, const BigInt &b) { return compare(a, b) >= 0; }
+
+    // Decimal digits. Peels off 19 digits per pass with one division per
+    // limb, so it is quadratic: fine for printing, not for hot loops.
+    std::string toString() const {
+        if (mag.empty()) return "0";
+        const Limb chunk = 10000000000000000000ull;   // 10^19
+        std::vector<Limb> rest = mag;
+        std::vector<Limb> parts;
+        while (!rest.empty()) {
+            Limb rem = 0;
+            for (size_t i = rest.size(); i-- > 0;) {
+                Wide cur = (Wide(rem) << 64) | rest[i];
+                rest[i] = Limb(cur / chunk);
+                rem = Limb(cur % chunk);
+            }
+            trim(rest);
+            parts.push_back(rem);
+        }
+        std::string s = negative ? "-" : "";
+        s += std::to_string(parts.back());
+        for (size_t i = parts.size() - 1; i-- > 0;) {
+            std::string d = std::to_string(parts[i]);
+            s.append(19 - d.size(), '0');
+            s += d;
+        }
+        return s;
+    }
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
+#include "btree.h"
+#include "avl.h"
+#include "bts.h"
+using namespace std;
+
+// Million lookups per second for one structure
+template <class F> double lookupRate(const vector<int> &probes, F contains) {
+    auto start = chrono::steady_clock::now();
+    size_t found = 0;
+    for (int x : probes) found += contains(x);
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    volatile size_t keep = found;
+    (void)keep;
+    return probes.size() / secs / 1e6;
+}
+
+// Lookup throughput of the binary layouts against the B+ tree layout.
+// Keys are the even numbers below 2n, so about half the probes hit.
+void benchmarkLayouts(size_t maxKeys, size_t lookups) {
+    cout << "Lookup throughput (M lookups/s, " << lookups << " random probes per size)\n";
+    cout << "      keys       AVL       BST  sorted+bsearch  S+tree\n";
+    mt19937 rng(99);
+    for (size_t n = 10000; n <= maxKeys; n *= 10) {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; i++) keys[i] = int(2 * i);
+        vector<int> probes(lookups);
+        for (int &p : probes) p = int(rng() % (2 * n));
+
+        double avlRate, bstRate, arrayRate, btreeRate;
+        {
+            AVLSet<int> avl;
+            avl.assignSorted(keys.begin(), keys.end());
+            avlRate = lookupRate(probes, [&](int x) { return avl.contains(x); });
+        }
+        {
+            Node* bst = buildFromSorted(keys.data(), n);
+            bstRate = lookupRate(probes, [&](int x) { return find(bst, x) != nullptr; });
+            destroyTree(bst);
+        }
+        arrayRate = lookupRate(probes, [&](int x) { return binary_search(keys.begin(), keys.end(), x); });
+        {
+            StaticBTreeSet<int> btree;
+            btree.assignSorted(keys.begin(), keys.end());
+            btreeRate = lookupRate(probes, [&](int x) { return btree.contains(x); });
+        }
+
+        cout << setw(10) << n << fixed << setprecision(2) << setw(10) << avlRate << setw(10) << bstRate
+             << setw(16) << arrayRate << setw(8) << btreeRate << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        size_t maxKeys = argc > 2 ? strtoul(argv[2], nullptr, 10) : 10000000;
+        size_t lookups = argc > 3 ? strtoul(argv[3], nullptr, 10) : 5000000;
+        benchmarkLayouts(maxKeys, lookups);
+        return 0;
+    }
+
+    int n;
+    cout << "enter the total number of keys: ";
+    cin >> n;
+    vector<int> keys(n);
+    for (int i = 0; i < n; i++) {
+        cin >> keys[i];
+    }
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+
+    StaticBTreeSet<int> tree;
+    tree.assignSorted(keys.begin(), keys.end());
+    cout << "Keys in order: ";
+    for (int key : tree) cout << key << " ";
+    cout << endl;
+
+    int x;
+    cout << "key to search: ";
+    cin >> x;
+    auto it = tree.lower_bound(x);
+    if (tree.contains(x)) cout << x << " found" << endl;
+    else if (it != tree.end()) cout << x << " not found, next key is " << *it << endl;
+    else cout << x << " not found, it is past the largest key" << endl;
+    return 0;
+}
@@ -0,0 +1,210 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Count of keys in one B-wide node that are < x (lower) or <= x (upper).
+// The generic version is a branch-free loop; 32-bit ints compare a whole
+// node with a handful of SIMD instructions.
+template <class Key, size_t B>
+struct NodeSearch {
+    static unsigned less(const Key* node, Key x) {
+        unsigned c = 0;
+        for (size_t i = 0; i < B; i++) c += node[i] < x;
+        return c;
+    }
+    static unsigned lessEqual(const Key* node, Key x) {
+        unsigned c = 0;
+        for (size_t i = 0; i < B; i++) c += !(x < node[i]);
+        return c;
+    }
+};
+
+#if defined(__AVX2__)
+template <>
+struct NodeSearch<int32_t, 16> {
+    static unsigned less(const int32_t* node, int32_t x) {
+        __m256i v = _mm256_set1_epi32(x);
+        __m256i a = _mm256_cmpgt_epi32(v, _mm256_load_si256((const __m256i*)node));
+        __m256i b = _mm256_cmpgt_epi32(v, _mm256_load_si256((const __m256i*)(node + 8)));
+        unsigned mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(a))) |
+                        unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(b))) << 8;
+        return unsigned(__builtin_popcount(mask));
+    }
+    static unsigned lessEqual(const int32_t* node, int32_t x) {
+        __m256i v = _mm256_set1_epi32(x);
+        __m256i a = _mm256_cmpgt_epi32(_mm256_load_si256((const __m256i*)node), v);
+        __m256i b = _mm256_cmpgt_epi32(_mm256_load_si256((const __m256i*)(node + 8)), v);
+        unsigned mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(a))) |
+                        unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(b))) << 8;
+        return 16 - unsigned(__builtin_popcount(mask));
+    }
+};
+#elif defined(__SSE2__)
+template <>
+struct NodeSearch<int32_t, 16> {
+    // bit i set when node[i] > x (greater) or x > node[i] (!greater)
+    template <bool Greater>
+    static unsigned mask(const int32_t* node, int32_t x) {
+        __m128i v = _mm_set1_epi32(x);
+        unsigned m = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i k = _mm_load_si128((const __m128i*)(node + 4 * i));
+            __m128i r = Greater ? _mm_cmpgt_epi32(k, v) : _mm_cmpgt_epi32(v, k);
+            m |= unsigned(_mm_movemask_ps(_mm_castsi128_ps(r))) << (4 * i);
+        }
+        return m;
+    }
+    static unsigned less(const int32_t* node, int32_t x) {
+        return unsigned(__builtin_popcount(mask<false>(node, x)));
+    }
+    static unsigned lessEqual(const int32_t* node, int32_t x) {
+        return 16 - unsigned(__builtin_popcount(mask<true>(node, x)));
+    }
+};
+#endif
+
+// Static ordered set in a B+ tree layout (an "S+ tree"). The sorted keys
+// form the leaf level, split into nodes of B keys. Each internal level
+// stores, per node, the smallest key of its children 1..B. A node of
+// 16 ints fills one 64-byte cache line, so a lookup costs about
+// log_17(n) cache misses, where a binary tree costs log_2(n). Each node
+// is searched with SIMD compares instead of a chain of branches.
+//
+// The tree is built once from sorted input and is read-only afterwards.
+// Keys must be arithmetic; numeric_limits<Key>::max() pads the last node.
+template <class Key, size_t B = 16>
+class StaticBTreeSet {
+    static_assert(std::is_arithmetic<Key>::value, "StaticBTreeSet needs arithmetic keys");
+
+private:
+    static constexpr size_t Align = 64;
+
+    Key* data = nullptr;           // all levels, cache-line aligned
+    size_t count = 0;
+    std::vector<size_t> offset;    // offset[0] is the leaf level, then upwards
+    std::vector<size_t> nodes;     // nodes per level
+
+    static Key sentinel() { return std::numeric_limits<Key>::max(); }
+
+    void release() {
+        if (data) ::operator delete(data, std::align_val_t(Align));
+        data = nullptr;
+    }
+
+    // Index of the first leaf key that the search moves past
+    template <bool Upper>
+    size_t search(Key x) const {
+        size_t j = 0;
+        for (size_t level = offset.size() - 1; level > 0; level--) {
+            const Key* node = data + offset[level] + j * B;
+            unsigned c = Upper ? NodeSearch<Key, B>::lessEqual(node, x) : NodeSearch<Key, B>::less(node, x);
+            j = j * (B + 1) + c;
+        }
+        const Key* leaf = data + j * B;
+        size_t i = j * B + (Upper ? NodeSearch<Key, B>::lessEqual(leaf, x) : NodeSearch<Key, B>::less(leaf, x));
+        return i < count ? i : count;
+    }
+
+public:
+    using value_type = Key;
+    using const_iterator = const Key*;
+    using iterator = const_iterator;
+
+    StaticBTreeSet() = default;
+    StaticBTreeSet(const StaticBTreeSet &) = delete;
+    StaticBTreeSet &operator=(const StaticBTreeSet &) = delete;
+
+    StaticBTreeSet(StaticBTreeSet &&other) noexcept { *this = std::move(other); }
+    StaticBTreeSet &operator=(StaticBTreeSet &&other) noexcept {
+        if (this != &other) {
+            release();
+            data = other.data;
+            count = other.count;
+            offset.swap(other.offset);
+            nodes.swap(other.nodes);
+            other.data = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    ~StaticBTreeSet() { release(); }
+
+    // Replaces the contents with sorted, duplicate-free keys in O(n)
+    template <class It>
+    void assignSorted(It first, It last) {
+        release();
+        offset.clear();
+        nodes.clear();
+        count = size_t(std::distance(first, last));
+
+        // level sizes: leaves, then one level per (B+1)-way fan-in up to a single node
+        size_t total = 0;
+        size_t n = (count + B - 1) / B;
+        if (n == 0) n = 1;
+        while (true) {
+            offset.push_back(total);
+            nodes.push_back(n);
+            total += n * B;
+            if (n == 1) break;
+            n = (n + B) / (B + 1);
+        }
+
+        data = static_cast<Key*>(::operator new(total * sizeof(Key), std::align_val_t(Align)));
+        size_t i = 0;
+        for (; first != last; ++first) data[i++] = *first;
+        for (; i < nodes[0] * B; i++) data[i] = sentinel();
+
+        // separator k of node j on level L: smallest key under child j*(B+1)+k+1,
+        // i.e. the first key of that child's leftmost leaf
+        size_t leavesPerChild = 1;
+        for (size_t level = 1; level < offset.size(); level++) {
+            for (size_t j = 0; j < nodes[level]; j++) {
+                for (size_t k = 0; k < B; k++) {
+                    size_t leaf = (j * (B + 1) + k + 1) * leavesPerChild;
+                    data[offset[level] + j * B + k] = leaf * B < count ? data[leaf * B] : sentinel();
+                }
+            }
+            leavesPerChild *= B + 1;
+        }
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const_iterator begin() const { return data; }
+    const_iterator end() const { return data + count; }
+
+    // First key not less than x
+    const_iterator lower_bound(Key x) const {
+        if (count == 0 || data[count - 1] < x) return end();
+        return data + search<false>(x);
+    }
+
+    // First key greater than x
+    const_iterator upper_bound(Key x) const {
+        if (count == 0 || !(x < data[count - 1])) return end();
+        return data + search<true>(x);
+    }
+
+    const_iterator find(Key x) const {
+        const_iterator it = lower_bound(x);
+        return it != end() && !(x < *it) ? it : end();
+    }
+
+    bool contains(Key x) const { return find(x) != end(); }
+};
+
+#endif
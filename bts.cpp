@@ -1,38 +1,75 @@
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include "bts.h"
+#include "treefile.h"
 using namespace std;
 
-struct Node {
-    int data;
-    Node* left;
-    Node* right;
-    Node(int val) {
-        data = val;
-        left = right = nullptr;
-    }
-};
+void inorder(Node* root) {
+    inorderIterative(root, [](Node* n) { cout << n->data << " "; });
+}
 
-Node* insert(Node* root, int val) {
-    if (root == nullptr) {
-        return new Node(val);
-    }
-    else if (val < root->data) {
-        root->left = insert(root->left, val);
-    }
-    else if (val > root->data) {
-        root->right = insert(root->right, val);
-    }
-    return root;
+template <class F> double secondsFor(F body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
 }
 
-void inorder(Node* root) {
-    if (root) {
-        inorder(root->left);
-        cout << root->data << " ";
-        inorder(root->right);
-    }
+// buildFromSorted against one insert per key. Repeated insert gets shuffled
+// keys: with sorted keys it degenerates to O(n^2).
+void benchmarkBuild(size_t n) {
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++) keys[i] = int(i);
+    vector<int> shuffled = keys;
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(7));
+
+    Node* bulk = nullptr;
+    Node* repeated = nullptr;
+    double bulkTime = secondsFor([&] { bulk = buildFromSorted(keys.data(), n); });
+    double insertTime = secondsFor([&] { for (int k : shuffled) repeated = insert(repeated, k); });
+
+    cout << "Building a BST of " << n << " keys\n" << fixed << setprecision(3);
+    cout << "  buildFromSorted        " << setw(9) << bulkTime << " s\n";
+    cout << "  insert, random input   " << setw(9) << insertTime << " s  ("
+         << setprecision(1) << insertTime / bulkTime << "x slower)\n" << setprecision(3);
+
+    Node* u = nullptr;
+    Node* x = nullptr;
+    double unionTime = secondsFor([&] { u = unionOf(bulk, repeated); });
+    double interTime = secondsFor([&] { x = intersectionOf(bulk, repeated); });
+    cout << "  union                  " << setw(9) << unionTime << " s\n";
+    cout << "  intersection           " << setw(9) << interTime << " s\n";
+
+    destroyTree(bulk);
+    destroyTree(repeated);
+    destroyTree(u);
+    destroyTree(x);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100000000;
+        benchmarkBuild(n);
+        return 0;
+    }
+
+    // --load file: query a saved tree in place instead of rebuilding it
+    if (argc > 2 && string(argv[1]) == "--load") {
+        MappedTree<int> saved;
+        if (!saved.open(argv[2])) {
+            cout << "Cannot load " << argv[2] << endl;
+            return 1;
+        }
+        saved.forEach([](int k) { cout << k << " "; });
+        cout << endl;
+        return 0;
+    }
+
     int n;
     cout << "enter the total number of nodes: ";
     cin >> n;
@@ -46,6 +83,12 @@ int main() {
     }
     cout << endl;
     inorder(root);
+    // --save file: keep the tree for later runs
+    if (argc > 2 && string(argv[1]) == "--save") {
+        vector<int> keys = toSortedVector(root);
+        if (!writeTreeFile<int>(argv[2], keys.begin(), keys.end())) cout << endl << "Cannot save " << argv[2];
+    }
+    destroyTree(root);
     delete[] arr;
     return 0;
 }
@@ -0,0 +1,106 @@
+#ifndef BTS_H
+#define BTS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stack>
+#include <vector>
+#include "traversal.h"
+
+struct Node {
+    int data;
+    Node* left;
+    Node* right;
+    Node(int val) {
+        data = val;
+        left = right = nullptr;
+    }
+};
+
+// Iterative, so sorted input (which turns the tree into a linked list)
+// cannot overflow the call stack
+inline Node* insert(Node* root, int val) {
+    if (root == nullptr) {
+        return new Node(val);
+    }
+    Node* cur = root;
+    while (true) {
+        if (val < cur->data) {
+            if (!cur->left) {
+                cur->left = new Node(val);
+                break;
+            }
+            cur = cur->left;
+        }
+        else if (val > cur->data) {
+            if (!cur->right) {
+                cur->right = new Node(val);
+                break;
+            }
+            cur = cur->right;
+        }
+        else {
+            break;
+        }
+    }
+    return root;
+}
+
+// Balanced tree from n sorted, duplicate-free keys in O(n): the middle
+// key becomes the root. Recursion depth is only log2(n).
+inline Node* buildFromSorted(const int* keys, size_t n) {
+    if (n == 0) {
+        return nullptr;
+    }
+    size_t mid = n / 2;
+    Node* root = new Node(keys[mid]);
+    root->left = buildFromSorted(keys, mid);
+    root->right = buildFromSorted(keys + mid + 1, n - mid - 1);
+    return root;
+}
+
+// Node holding val, or nullptr
+inline Node* find(Node* root, int val) {
+    while (root && root->data != val) {
+        root = val < root->data ? root->left : root->right;
+    }
+    return root;
+}
+
+// Keys in sorted order, walked with an explicit stack
+inline std::vector<int> toSortedVector(Node* root) {
+    std::vector<int> keys;
+    inorderIterative(root, [&](Node* n) { keys.push_back(n->data); });
+    return keys;
+}
+
+// Balanced tree of the keys in a or b, in O(|a| + |b|)
+inline Node* unionOf(Node* a, Node* b) {
+    std::vector<int> x = toSortedVector(a), y = toSortedVector(b), merged;
+    merged.reserve(x.size() + y.size());
+    std::set_union(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(merged));
+    return buildFromSorted(merged.data(), merged.size());
+}
+
+// Balanced tree of the keys in both a and b, in O(|a| + |b|)
+inline Node* intersectionOf(Node* a, Node* b) {
+    std::vector<int> x = toSortedVector(a), y = toSortedVector(b), common;
+    std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(common));
+    return buildFromSorted(common.data(), common.size());
+}
+
+// Frees every node without recursion
+inline void destroyTree(Node* root) {
+    std::stack<Node*> st;
+    if (root) st.push(root);
+    while (!st.empty()) {
+        Node* n = st.top();
+        st.pop();
+        if (n->left) st.push(n->left);
+        if (n->right) st.push(n->right);
+        delete n;
+    }
+}
+
+#endif
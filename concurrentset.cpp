@@ -0,0 +1,290 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <unordered_set>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
+#include "concurrentset.h"
+#include "avl.h"
+using namespace std;
+
+// ---------------- Linearizability stress test ----------------
+// Threads hammer a small key range with insert/erase/contains and log
+// each call with invocation and response stamps from a shared counter.
+// A set is linearizable exactly when the history of every single key is
+// (each key behaves like an independent boolean register), so every
+// key's history is checked on its own: a depth-first search looks for an
+// order that respects real time and explains every result.
+
+enum SetOp { OP_INSERT, OP_ERASE, OP_CONTAINS };
+
+struct Event {
+    int key;
+    SetOp op;
+    bool result;
+    uint64_t invoke, response;
+};
+
+enum Verdict { LINEARIZABLE, NOT_LINEARIZABLE, TOO_LONG };
+
+const size_t MaxCheckedEvents = 30;   // the search tracks finished events in a 32-bit mask
+
+// Does a legal sequential order exist for the events of one key? Longer
+// histories than the search can handle are reported, not passed.
+Verdict linearizable(const vector<Event> &ev) {
+    size_t n = ev.size();
+    if (n > MaxCheckedEvents) return TOO_LONG;
+    unordered_set<uint64_t> failed;   // memo of (done mask, present) dead ends
+
+    function<bool(uint32_t, bool)> search = [&](uint32_t done, bool present) {
+        if (done == (uint32_t(1) << n) - 1) return true;
+        uint64_t memo = (uint64_t(done) << 1) | present;
+        if (failed.count(memo)) return false;
+
+        // earliest response among pending events: nothing invoked after it can go first
+        uint64_t horizon = UINT64_MAX;
+        for (size_t i = 0; i < n; i++) {
+            if (!(done >> i & 1)) horizon = min(horizon, ev[i].response);
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (done >> i & 1 || ev[i].invoke > horizon) continue;
+            bool expected, next;
+            switch (ev[i].op) {
+                case OP_INSERT: expected = !present; next = true; break;
+                case OP_ERASE: expected = present; next = false; break;
+                default: expected = present; next = present; break;
+            }
+            if (ev[i].result == expected && search(done | uint32_t(1) << i, next)) return true;
+        }
+        failed.insert(memo);
+        return false;
+    };
+    return search(0, false) ? LINEARIZABLE : NOT_LINEARIZABLE;
+}
+
+int stressTest(int threads, int rounds) {
+    int failures = 0;
+    long checkedKeys = 0, skippedKeys = 0;
+    for (int round = 0; round < rounds; round++) {
+        const int keys = 64;
+        const int opsPerThread = 2 * keys * 6 / threads + 1;   // about a dozen events per key
+
+        ConcurrentSkipListSet<int> set;
+        atomic<uint64_t> clock{0};
+        vector<vector<Event>> logs(threads);
+        atomic<int> ready{0};
+
+        vector<thread> pool;
+        for (int t = 0; t < threads; t++) {
+            pool.emplace_back([&, t] {
+                mt19937 rng(round * 1000 + t);
+                ready++;
+                while (ready.load() < threads) {}   // start together for maximum overlap
+                for (int i = 0; i < opsPerThread; i++) {
+                    Event e;
+                    e.key = int(rng() % keys);
+                    e.op = SetOp(rng() % 3);
+                    e.invoke = clock.fetch_add(1);
+                    switch (e.op) {
+                        case OP_INSERT: e.result = set.insert(e.key); break;
+                        case OP_ERASE: e.result = set.erase(e.key); break;
+                        default: e.result = set.contains(e.key); break;
+                    }
+                    e.response = clock.fetch_add(1);
+                    logs[t].push_back(e);
+                }
+            });
+        }
+        for (auto &th : pool) th.join();
+
+        map<int, vector<Event>> byKey;
+        for (auto &log : logs) {
+            for (auto &e : log) byKey[e.key].push_back(e);
+        }
+        for (auto &kv : byKey) {
+            Verdict v = linearizable(kv.second);
+            if (v == TOO_LONG) {
+                skippedKeys++;
+                continue;
+            }
+            checkedKeys++;
+            if (v == NOT_LINEARIZABLE) {
+                if (failures++ < 5) cout << "FAIL: history of key " << kv.first << " is not linearizable\n";
+            }
+        }
+
+        // quiescent state must match the last linearized operations
+        size_t visited = 0;
+        int prev = -1;
+        bool ordered = true;
+        set.forEach([&](int k) {
+            ordered = ordered && k > prev;
+            prev = k;
+            visited++;
+        });
+        if (!ordered || visited != set.size()) {
+            if (failures++ < 5) cout << "FAIL: quiescent set is inconsistent\n";
+        }
+    }
+    cout << "Checked " << checkedKeys << " key histories over " << rounds << " rounds with "
+         << threads << " threads: " << (failures ? "FAILED" : "linearizable") << "\n";
+    if (skippedKeys) {
+        cout << "Skipped " << skippedKeys << " key histories with more than " << MaxCheckedEvents
+             << " events (not checked)\n";
+    }
+    return failures ? 1 : 0;
+}
+
+// Erased nodes must be freed as the set runs: under constant churn the
+// nodes held stay near the live key count, not the number of inserts
+int churnTest(int threads, long opsPerThread) {
+    const int keys = 1024;
+    ConcurrentSkipListSet<int> set;
+    atomic<size_t> peak{0};
+    atomic<long> inserted{0};
+    atomic<int> ready{0};
+
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            mt19937 rng(t + 7);
+            ready++;
+            while (ready.load() < threads) {}
+            long mine = 0;
+            for (long i = 0; i < opsPerThread; i++) {
+                int key = int(rng() % keys);
+                if (rng() % 2) mine += set.insert(key);
+                else set.erase(key);
+                if (i % 256 == 0) {
+                    size_t held = set.allocatedNodes(), seen = peak.load();
+                    while (held > seen && !peak.compare_exchange_weak(seen, held)) {}
+                }
+            }
+            inserted += mine;
+        });
+    }
+    for (auto &th : pool) th.join();
+
+    // A thread descheduled inside a call holds reclamation back for its
+    // time slice, so the peak depends on the scheduler. Without
+    // reclamation it would reach the number of inserts.
+    bool ok = long(peak.load()) <= max(inserted.load() / 8, long(keys) * 4);
+    cout << "Churn: " << inserted.load() << " inserts into " << keys << " keys held at most " << peak.load()
+         << " nodes: " << (ok ? "bounded" : "NOT RECLAIMED") << "\n";
+    return ok ? 0 : 1;
+}
+
+// ---------------- Throughput ----------------
+
+// Same interface for every contender
+struct LockedStdSet {
+    mutex lock;
+    set<int> s;
+    bool insert(int k) { lock_guard<mutex> g(lock); return s.insert(k).second; }
+    bool erase(int k) { lock_guard<mutex> g(lock); return s.erase(k) > 0; }
+    bool contains(int k) { lock_guard<mutex> g(lock); return s.count(k) > 0; }
+};
+
+// AVL tree behind a reader-writer lock: lookups run in parallel
+struct SharedLockedAVL {
+    shared_mutex lock;
+    AVLSet<int> s;
+    bool insert(int k) { unique_lock<shared_mutex> g(lock); return s.insert(k).second; }
+    bool erase(int k) { unique_lock<shared_mutex> g(lock); return s.erase(k) > 0; }
+    bool contains(int k) { shared_lock<shared_mutex> g(lock); return s.contains(k); }
+};
+
+template <class Set>
+double mixedThroughput(Set &s, int threads, int readPercent, long opsPerThread, int keyRange) {
+    for (int k = 0; k < keyRange; k += 2) s.insert(k);   // half full
+
+    vector<thread> pool;
+    atomic<int> ready{0};
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            mt19937 rng(t + 1);
+            ready++;
+            while (ready.load() < threads) {}
+            long hits = 0;
+            for (long i = 0; i < opsPerThread; i++) {
+                int key = int(rng() % keyRange);
+                int dice = int(rng() % 100);
+                if (dice < readPercent) hits += s.contains(key);
+                else if (dice % 2) hits += s.insert(key);
+                else hits += s.erase(key);
+            }
+            volatile long keep = hits;
+            (void)keep;
+        });
+    }
+    for (auto &th : pool) th.join();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return threads * opsPerThread / secs / 1e6;
+}
+
+void benchmarkScaling(long opsPerThread) {
+    const int keyRange = 1 << 20;
+    int cores = max(1u, thread::hardware_concurrency());
+    vector<int> counts;
+    for (int t = 1; t < cores; t *= 2) counts.push_back(t);
+    counts.push_back(cores);
+
+    for (int readPercent : {90, 50}) {
+        cout << "\n" << readPercent << "% contains, " << (100 - readPercent) / 2 << "% insert, "
+             << (100 - readPercent) / 2 << "% erase (M ops/s)\n";
+        cout << "threads  skiplist  mutex+std::set  shared_mutex+AVL\n";
+        for (int t : counts) {
+            ConcurrentSkipListSet<int> skip;
+            LockedStdSet locked;
+            SharedLockedAVL avl;
+            double a = mixedThroughput(skip, t, readPercent, opsPerThread, keyRange);
+            double b = mixedThroughput(locked, t, readPercent, opsPerThread, keyRange);
+            double c = mixedThroughput(avl, t, readPercent, opsPerThread, keyRange);
+            cout << setw(7) << t << fixed << setprecision(2) << setw(10) << a << setw(16) << b << setw(18) << c << "\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--stress") {
+        int threads = argc > 2 ? atoi(argv[2]) : max(4u, thread::hardware_concurrency());
+        int rounds = argc > 3 ? atoi(argv[3]) : 200;
+        int failed = stressTest(max(threads, 1), rounds);
+        return churnTest(max(threads, 1), 200000) || failed;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        long ops = argc > 2 ? atol(argv[2]) : 1000000;
+        benchmarkScaling(ops);
+        return 0;
+    }
+
+    // a few threads fill disjoint ranges of one shared set
+    ConcurrentSkipListSet<int> index;
+    vector<thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&index, t] {
+            for (int k = t * 10; k < t * 10 + 10; k++) index.insert(k);
+        });
+    }
+    for (auto &w : writers) w.join();
+    for (int k = 0; k < 40; k += 3) index.erase(k);
+
+    cout << "Shared index holds " << index.size() << " keys: ";
+    index.forEach([](int k) { cout << k << " "; });
+    cout << endl;
+
+    int next;
+    if (index.lowerBound(25, next)) cout << "First key >= 25: " << next << endl;
+    return 0;
+}
@@ -0,0 +1,365 @@
+#ifndef CONCURRENTSET_H
+#define CONCURRENTSET_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Lock-free ordered set for indexes shared between threads, after the
+// lock-free skip list of Herlihy & Shavit. Every level is a linked list
+// whose next pointers carry a "marked" bit in their lowest bit. erase
+// first marks a node's pointers (logical delete), then lets find() unlink
+// it (physical delete). insert publishes a node with one CAS on the
+// bottom level, which is its linearization point. contains never retries.
+//
+// Erased nodes are reclaimed by epochs. Every call claims a slot and
+// records the global epoch in it while it runs. A node is retired once
+// it is unlinked from every level and freed when the epoch has advanced
+// twice since, which happens only after every call that could still hold
+// a pointer to it has returned. Memory for erased keys is bounded by
+// RetireBatch nodes per slot (one slot per call in flight) plus whatever
+// is erased while the oldest running call is still inside the set; a
+// thread stalled in a call, or a long forEach, holds reclamation back
+// until it returns. Key must be default-constructible (for the
+// sentinels) and copyable.
+template <class Key, class Compare = std::less<Key>>
+class ConcurrentSkipListSet {
+private:
+    static constexpr int MaxLevel = 24;
+    static constexpr size_t RetireBatch = 64;   // retired nodes per slot before trying to free them
+    static constexpr uint64_t Idle = ~uint64_t(0);
+
+    struct Node {
+        Key key;
+        int topLevel;
+        std::atomic<int> owners{2};   // the inserter and the eraser; see release()
+        std::unique_ptr<std::atomic<uintptr_t>[]> next;
+
+        Node(const Key &k, int top) : key(k), topLevel(top), next(new std::atomic<uintptr_t>[top + 1]) {
+            for (int i = 0; i <= top; i++) next[i].store(0, std::memory_order_relaxed);
+        }
+    };
+
+    // Claimed by one call at a time, so threads that exit leave nothing
+    // behind. epoch is Idle while the slot is free.
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{Idle};
+        std::atomic<bool> busy{false};
+        Slot* nextSlot = nullptr;
+        std::vector<std::pair<uint64_t, Node*>> retired;   // (epoch when retired, node)
+    };
+
+    // Keeps the calling thread's slot pinned for one public call
+    class Guard {
+    private:
+        const ConcurrentSkipListSet &set;
+
+    public:
+        Slot* slot;
+
+        explicit Guard(const ConcurrentSkipListSet &s) : set(s), slot(s.pin()) {}
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+        ~Guard() { set.unpin(slot); }
+    };
+
+    Node* head;
+    Node* tail;
+    Compare less;
+    const uint64_t id = nextId();   // tells the per-thread slot hints of different sets apart
+    mutable std::atomic<Slot*> slots{nullptr};
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<long> count{0};
+    std::atomic<long> allocated{0};
+    std::atomic<int> levelHint{0};   // highest level any node uses; searches start there
+
+    static Node* ref(uintptr_t p) { return reinterpret_cast<Node*>(p & ~uintptr_t(1)); }
+    static bool isMarked(uintptr_t p) { return p & 1; }
+    static uintptr_t pack(Node* n) { return reinterpret_cast<uintptr_t>(n); }
+
+    // curr sorts before x (the tail sorts after everything)
+    bool before(const Node* curr, const Key &x) const { return curr != tail && less(curr->key, x); }
+
+    static int randomLevel() {
+        thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ uint64_t(reinterpret_cast<uintptr_t>(&state));
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        // geometric with p = 1/2
+        return __builtin_ctzll(state | (uint64_t(1) << (MaxLevel - 1)));
+    }
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> ids{0};
+        return ++ids;
+    }
+
+    // Claims a free slot, preferring the one this thread used last, and
+    // publishes the epoch the call started in
+    Slot* pin() const {
+        thread_local std::pair<uint64_t, Slot*> hint{0, nullptr};
+        Slot* slot = nullptr;
+        if (hint.first == id && !hint.second->busy.exchange(true)) slot = hint.second;
+        for (Slot* s = slots.load(); !slot && s; s = s->nextSlot) {
+            if (!s->busy.load(std::memory_order_relaxed) && !s->busy.exchange(true)) slot = s;
+        }
+        if (!slot) {
+            slot = new Slot;
+            slot->busy.store(true);
+            Slot* old = slots.load();
+            do {
+                slot->nextSlot = old;
+            } while (!slots.compare_exchange_weak(old, slot));
+        }
+        hint = {id, slot};
+        slot->epoch.store(epoch.load());
+        return slot;
+    }
+
+    void unpin(Slot* slot) const {
+        slot->epoch.store(Idle);
+        slot->busy.store(false);
+    }
+
+    // The epoch moves on only when every call in flight has seen it
+    void tryAdvance() {
+        uint64_t current = epoch.load();
+        for (Slot* s = slots.load(); s; s = s->nextSlot) {
+            uint64_t e = s->epoch.load();
+            if (e != Idle && e != current) return;
+        }
+        epoch.compare_exchange_strong(current, current + 1);
+    }
+
+    // Frees the nodes retired two or more epochs ago: no call that
+    // started before they were unlinked can still be running
+    void reclaim(Slot* slot) {
+        tryAdvance();
+        uint64_t safe = epoch.load();
+        size_t kept = 0;
+        for (auto &r : slot->retired) {
+            if (r.first + 2 <= safe) {
+                delete r.second;
+                allocated--;
+            } else {
+                slot->retired[kept++] = r;
+            }
+        }
+        slot->retired.resize(kept);
+    }
+
+    // The inserter drops its claim once it has stopped linking levels,
+    // the eraser once it has marked the node. Whoever drops the last one
+    // knows nobody will link the node again, so one more find() unlinks
+    // it from every level and it can be retired.
+    void release(Node* n, Slot* slot) {
+        if (n->owners.fetch_sub(1) != 1) return;
+        Node* preds[MaxLevel];
+        Node* succs[MaxLevel];
+        find(n->key, preds, succs);
+        slot->retired.emplace_back(epoch.load(), n);
+        if (slot->retired.size() >= RetireBatch) reclaim(slot);
+    }
+
+    // Fills preds/succs with the window around x on every level and
+    // unlinks marked nodes on the way. Returns whether x is present.
+    bool find(const Key &x, Node** preds, Node** succs) {
+        while (true) {
+            bool restart = false;
+            Node* pred = head;
+            for (int level = levelHint.load(); level >= 0 && !restart; level--) {
+                Node* curr = ref(pred->next[level].load());
+                while (true) {
+                    uintptr_t succ = curr->next[level].load();
+                    while (isMarked(succ)) {
+                        uintptr_t expected = pack(curr);
+                        if (!pred->next[level].compare_exchange_strong(expected, pack(ref(succ)))) {
+                            restart = true;   // pred changed under us
+                            break;
+                        }
+                        curr = ref(succ);
+                        succ = curr->next[level].load();
+                    }
+                    if (restart) break;
+                    if (!before(curr, x)) break;
+                    pred = curr;
+                    curr = ref(succ);
+                }
+                preds[level] = pred;
+                succs[level] = curr;
+            }
+            if (!restart) return succs[0] != tail && !less(x, succs[0]->key);
+        }
+    }
+
+public:
+    ConcurrentSkipListSet() {
+        head = new Node(Key(), MaxLevel - 1);
+        tail = new Node(Key(), MaxLevel - 1);
+        for (int i = 0; i < MaxLevel; i++) head->next[i].store(pack(tail));
+    }
+
+    ConcurrentSkipListSet(const ConcurrentSkipListSet &) = delete;
+    ConcurrentSkipListSet &operator=(const ConcurrentSkipListSet &) = delete;
+
+    // Not thread-safe: no other thread may be using the set
+    ~ConcurrentSkipListSet() {
+        // with no call in flight every node is either on the bottom level
+        // or retired, never both
+        Node* n = ref(head->next[0].load());
+        while (n != tail) {
+            Node* nxt = ref(n->next[0].load());
+            delete n;
+            n = nxt;
+        }
+        Slot* s = slots.load();
+        while (s) {
+            for (auto &r : s->retired) delete r.second;
+            Slot* nxt = s->nextSlot;
+            delete s;
+            s = nxt;
+        }
+        delete head;
+        delete tail;
+    }
+
+    bool insert(const Key &x) {
+        Guard guard(*this);
+        Node* preds[MaxLevel];
+        Node* succs[MaxLevel];
+        int top = randomLevel();
+        Node* node = nullptr;
+
+        // raise the hint first, so find() fills preds/succs up to our top level
+        int hint = levelHint.load();
+        while (hint < top && !levelHint.compare_exchange_weak(hint, top)) {}
+
+        while (true) {
+            if (find(x, preds, succs)) {
+                if (node) {
+                    delete node;   // never published
+                    allocated--;
+                }
+                return false;
+            }
+            if (!node) {
+                node = new Node(x, top);
+                allocated++;
+            }
+            for (int level = 0; level <= top; level++) node->next[level].store(pack(succs[level]));
+
+            uintptr_t expected = pack(succs[0]);
+            if (!preds[0]->next[0].compare_exchange_strong(expected, pack(node))) continue;
+            break;
+        }
+        count++;
+
+        // link the upper levels; they only speed up searches
+        bool erased = false;
+        for (int level = 1; level <= top && !erased; level++) {
+            while (true) {
+                uintptr_t mine = node->next[level].load();
+                if (isMarked(mine)) {
+                    erased = true;   // already being erased
+                    break;
+                }
+                if (ref(mine) != succs[level] &&
+                    !node->next[level].compare_exchange_strong(mine, pack(succs[level]))) {
+                    continue;
+                }
+                uintptr_t expected = pack(succs[level]);
+                if (preds[level]->next[level].compare_exchange_strong(expected, pack(node))) break;
+                find(x, preds, succs);
+            }
+        }
+        release(node, guard.slot);
+        return true;
+    }
+
+    bool erase(const Key &x) {
+        Guard guard(*this);
+        Node* preds[MaxLevel];
+        Node* succs[MaxLevel];
+        if (!find(x, preds, succs)) return false;
+        Node* victim = succs[0];
+
+        // mark the upper levels top-down, then race for the bottom mark
+        for (int level = victim->topLevel; level >= 1; level--) {
+            uintptr_t succ = victim->next[level].load();
+            while (!isMarked(succ)) {
+                if (victim->next[level].compare_exchange_weak(succ, succ | 1)) break;
+            }
+        }
+        uintptr_t succ = victim->next[0].load();
+        while (!isMarked(succ)) {
+            if (victim->next[0].compare_exchange_weak(succ, succ | 1)) {
+                count--;
+                release(victim, guard.slot);   // unlinks and retires it, or leaves that to the inserter
+                return true;
+            }
+        }
+        return false;   // another thread erased it first
+    }
+
+    // Walks past marked nodes without helping to unlink them; the only
+    // write is to the caller's slot
+    bool contains(const Key &x) const {
+        Guard guard(*this);
+        const Node* curr = lowerBoundNode(x);
+        return curr != tail && !less(x, curr->key);
+    }
+
+    // Smallest key not less than x, if any
+    bool lowerBound(const Key &x, Key &out) const {
+        Guard guard(*this);
+        const Node* curr = lowerBoundNode(x);
+        if (curr == tail) return false;
+        out = curr->key;
+        return true;
+    }
+
+    // Visits keys in order. Weakly consistent: concurrent updates may or
+    // may not be seen. Nothing erased meanwhile is freed until it returns.
+    template <class F>
+    void forEach(F visit) const {
+        Guard guard(*this);
+        Node* curr = ref(head->next[0].load());
+        while (curr != tail) {
+            uintptr_t succ = curr->next[0].load();
+            if (!isMarked(succ)) visit(curr->key);
+            curr = ref(succ);
+        }
+    }
+
+    // Exact when no updates are in flight
+    size_t size() const { return size_t(count.load()); }
+    bool empty() const { return size() == 0; }
+
+    // Nodes in memory, including erased ones not yet freed
+    size_t allocatedNodes() const { return size_t(allocated.load()); }
+
+private:
+    const Node* lowerBoundNode(const Key &x) const {
+        const Node* pred = head;
+        const Node* curr = nullptr;
+        for (int level = levelHint.load(); level >= 0; level--) {
+            curr = ref(pred->next[level].load());
+            while (true) {
+                uintptr_t succ = curr->next[level].load();
+                while (isMarked(succ)) {
+                    curr = ref(succ);
+                    succ = curr->next[level].load();
+                }
+                if (!before(curr, x)) break;
+                pred = curr;
+                curr = ref(succ);
+            }
+        }
+        return curr;
+    }
+};
+
+#endif
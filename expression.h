@@ -0,0 +1,221 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <stack>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// Infix to postfix conversion and postfix evaluation, shared by the
+// calculator and the benchmark suite.
+
+// Function to set precedence of operators ('~' is unary minus)
+inline int precedence(char op) {
+    if (op == '^') return 4;
+    if (op == '~') return 3;
+    if (op == '*' || op == '/') return 2;
+    if (op == '+' || op == '-') return 1;
+    return 0;
+}
+
+// '^' and unary minus group right to left: 2^3^2 = 2^(3^2)
+inline bool isRightAssociative(char op) {
+    return op == '^' || op == '~';
+}
+
+// Check if character is operator
+inline bool isOperator(char c) {
+    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '^');
+}
+
+// Same set as isspace in the C locale, without the locale lookup
+inline bool isSpaceChar(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Malformed expression; position is the 0-based offset of the offending character
+class ExpressionError : public std::runtime_error {
+public:
+    size_t position;
+
+    ExpressionError(const std::string &message, size_t pos) : std::runtime_error(message), position(pos) {}
+};
+
+enum TokenKind { TOK_NUMBER, TOK_VARIABLE, TOK_OPERATOR, TOK_LPAREN, TOK_RPAREN, TOK_END };
+
+struct Token {
+    TokenKind kind;
+    char op;        // operator character or variable name
+    double value;   // for TOK_NUMBER
+    size_t pos;     // offset in the source text
+};
+
+// Single-pass lexer shared by the infix parser and the postfix readers.
+// It works on a string_view and parses numbers in place with from_chars,
+// so it never allocates (except to build an error message).
+class Lexer {
+private:
+    std::string_view src;
+    size_t pos = 0;
+    bool postfix;   // postfix text also contains '~'
+
+public:
+    explicit Lexer(std::string_view text, bool postfixText = false) : src(text), postfix(postfixText) {}
+
+    Token next() {
+        while (pos < src.size() && isSpaceChar(src[pos])) pos++;
+        if (pos == src.size()) return {TOK_END, 0, 0.0, pos};
+
+        size_t start = pos;
+        char c = src[pos];
+        if (std::isdigit((unsigned char)c) || c == '.') {
+            double v = 0.0;
+            auto r = std::from_chars(src.data() + pos, src.data() + src.size(), v);
+            if (r.ec == std::errc::invalid_argument) throw ExpressionError("malformed number", start);
+            if (r.ec == std::errc::result_out_of_range) throw ExpressionError("number out of range", start);
+            pos = r.ptr - src.data();
+            return {TOK_NUMBER, 0, v, start};
+        }
+
+        pos++;
+        if (c >= 'a' && c <= 'z') return {TOK_VARIABLE, c, 0.0, start};
+        if (c == '(') return {TOK_LPAREN, c, 0.0, start};
+        if (c == ')') return {TOK_RPAREN, c, 0.0, start};
+        if (isOperator(c) || (postfix && c == '~')) return {TOK_OPERATOR, c, 0.0, start};
+        throw ExpressionError(std::string("unexpected character '") + c + "'", start);
+    }
+};
+
+// Shortest text that reads back as exactly the same double
+inline void appendNumber(std::string &out, double v) {
+    char buf[32];
+    auto r = std::to_chars(buf, buf + sizeof buf, v);
+    out.append(buf, r.ptr);
+}
+
+// Convert Infix to Postfix. Throws ExpressionError on malformed input.
+inline std::string infixToPostfix(const std::string &infix) {
+    Lexer lex(infix);
+    std::vector<Token> st;   // pending operators and '('
+    std::string postfix;
+    postfix.reserve(infix.size() * 2);
+    bool expectOperand = true;
+
+    for (Token t = lex.next(); t.kind != TOK_END; t = lex.next()) {
+        switch (t.kind) {
+            case TOK_NUMBER:
+            case TOK_VARIABLE:
+                if (!expectOperand) throw ExpressionError("missing operator before operand", t.pos);
+                if (t.kind == TOK_NUMBER) appendNumber(postfix, t.value);
+                else postfix += t.op;
+                postfix += ' ';
+                expectOperand = false;
+                break;
+
+            case TOK_LPAREN:
+                if (!expectOperand) throw ExpressionError("missing operator before '('", t.pos);
+                st.push_back(t);
+                break;
+
+            case TOK_RPAREN:
+                if (expectOperand) throw ExpressionError("missing operand before ')'", t.pos);
+                while (!st.empty() && st.back().kind != TOK_LPAREN) {
+                    postfix += st.back().op;
+                    postfix += ' ';
+                    st.pop_back();
+                }
+                if (st.empty()) throw ExpressionError("unmatched ')'", t.pos);
+                st.pop_back(); // remove '('
+                break;
+
+            case TOK_OPERATOR:
+                if (expectOperand) {
+                    // sign in front of an operand: '-' negates, '+' is a no-op
+                    if (t.op == '-') {
+                        t.op = '~';
+                        st.push_back(t);
+                    } else if (t.op != '+') {
+                        throw ExpressionError(std::string("missing operand before '") + t.op + "'", t.pos);
+                    }
+                    break;
+                }
+                while (!st.empty() && st.back().kind == TOK_OPERATOR &&
+                       (precedence(st.back().op) > precedence(t.op) ||
+                        (precedence(st.back().op) == precedence(t.op) && !isRightAssociative(t.op)))) {
+                    postfix += st.back().op;
+                    postfix += ' ';
+                    st.pop_back();
+                }
+                st.push_back(t);
+                expectOperand = true;
+                break;
+
+            case TOK_END:
+                break;
+        }
+    }
+
+    if (expectOperand) {
+        bool empty = postfix.empty() && st.empty();
+        throw ExpressionError(empty ? "empty expression" : "missing operand at end", infix.size());
+    }
+
+    // Pop remaining operators
+    while (!st.empty()) {
+        if (st.back().kind == TOK_LPAREN) throw ExpressionError("unmatched '('", st.back().pos);
+        postfix += st.back().op;
+        postfix += ' ';
+        st.pop_back();
+    }
+
+    return postfix;
+}
+
+// Evaluate Postfix Expression (vars holds the values of a..z, may be null).
+// Throws ExpressionError instead of popping an empty stack.
+inline double evaluatePostfix(const std::string &postfix, const double* vars = nullptr) {
+    std::stack<double> st;
+    Lexer lex(postfix, true);
+
+    for (Token t = lex.next(); t.kind != TOK_END; t = lex.next()) {
+        if (t.kind == TOK_NUMBER) {
+            st.push(t.value);
+        }
+        else if (t.kind == TOK_VARIABLE) {
+            st.push(vars ? vars[t.op - 'a'] : 0.0);
+        }
+        else if (t.kind == TOK_OPERATOR && t.op == '~') {
+            if (st.empty()) throw ExpressionError("missing operand for unary '-'", t.pos);
+            st.top() = -st.top();
+        }
+        else if (t.kind == TOK_OPERATOR) {
+            if (st.size() < 2) throw ExpressionError(std::string("missing operand for '") + t.op + "'", t.pos);
+            double val2 = st.top(); st.pop();
+            double val1 = st.top(); st.pop();
+
+            switch (t.op) {
+                case '+': st.push(val1 + val2); break;
+                case '-': st.push(val1 - val2); break;
+                case '*': st.push(val1 * val2); break;
+                case '/': st.push(val1 / val2); break;
+                case '^': st.push(std::pow(val1, val2)); break;
+            }
+        }
+        else {
+            throw ExpressionError("parenthesis in postfix expression", t.pos);
+        }
+    }
+
+    if (st.size() != 1) {
+        throw ExpressionError(st.empty() ? "empty expression" : "missing operator", postfix.size());
+    }
+    return st.top();
+}
+
+#endif
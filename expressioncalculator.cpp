@@ -3,114 +3,1169 @@
 #include <string>
 #include <cctype>
 #include <cmath>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <tuple>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <chrono>
+#include <iomanip>
+#include <list>
+#include <deque>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <functional>
+#include <cstdlib>
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <stdexcept>
+#include "expression.h"
 using namespace std;
 
-// Function to set precedence of operators
-int precedence(char op) {
-    if (op == '^') return 3;
-    if (op == '*' || op == '/') return 2;
-    if (op == '+' || op == '-') return 1;
-    return 0;
+// ---------------- Bytecode VM ----------------
+// The postfix string is compiled once into a flat instruction list, so
+// repeated evaluation skips all string scanning and number parsing.
+
+enum OpCode : unsigned char {
+    OP_PUSH, OP_LOAD, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW,
+    OP_NEG,     // unary minus
+    OP_STORE,   // copy top of stack into a temp slot (value stays on the stack)
+    OP_TEMP     // push a temp slot
+};
+
+struct Instr {
+    OpCode op;
+    int slot;       // variable index for OP_LOAD, temp index for OP_STORE/OP_TEMP
+    double value;   // constant for OP_PUSH
+};
+
+struct Program {
+    vector<Instr> code;
+    int maxDepth = 0;   // deepest stack the program needs
+    int numTemps = 0;   // temp slots used for common subexpressions
+};
+
+OpCode opcodeFor(char op) {
+    switch (op) {
+        case '+': return OP_ADD;
+        case '-': return OP_SUB;
+        case '*': return OP_MUL;
+        case '/': return OP_DIV;
+        case '~': return OP_NEG;
+        default:  return OP_POW;
+    }
 }
 
-// Check if character is operator
-bool isOperator(char c) {
-    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '^');
+// Compile Postfix to bytecode. Throws ExpressionError on malformed input.
+Program compilePostfix(const string &postfix) {
+    Program prog;
+    int depth = 0;
+    Lexer lex(postfix, true);
+
+    for (Token t = lex.next(); t.kind != TOK_END; t = lex.next()) {
+        if (t.kind == TOK_NUMBER) {
+            prog.code.push_back({OP_PUSH, 0, t.value});
+            depth++;
+        }
+        else if (t.kind == TOK_VARIABLE) {
+            prog.code.push_back({OP_LOAD, t.op - 'a', 0.0});
+            depth++;
+        }
+        else if (t.kind == TOK_OPERATOR) {
+            int arity = t.op == '~' ? 1 : 2;
+            if (depth < arity) throw ExpressionError(string("missing operand for '") + t.op + "'", t.pos);
+            prog.code.push_back({opcodeFor(t.op), 0, 0.0});
+            depth -= arity - 1;
+        }
+        else {
+            throw ExpressionError("parenthesis in postfix expression", t.pos);
+        }
+        prog.maxDepth = max(prog.maxDepth, depth);
+    }
+
+    if (depth != 1) {
+        throw ExpressionError(depth == 0 ? "empty expression" : "missing operator", postfix.size());
+    }
+    return prog;
 }
 
-// Convert Infix to Postfix
-string infixToPostfix(string infix) {
-    stack<char> st;
-    string postfix = "";
+// Run compiled bytecode
+double runProgram(const Program &prog, const double* vars) {
+    if (prog.code.empty()) return 0.0;
 
-    for (size_t i = 0; i < infix.length(); i++) {
-        char c = infix[i];
+    // temps live at the bottom of the buffer, the stack above them
+    double small[64];
+    vector<double> big;
+    double* temps = small;
+    if (prog.numTemps + prog.maxDepth > 64) {
+        big.resize(prog.numTemps + prog.maxDepth);
+        temps = big.data();
+    }
+    double* st = temps + prog.numTemps;
 
-        // If operand (number or variable)
-        if (isdigit(c)) {
-            // Handle multi-digit numbers
-            while (i < infix.length() && isdigit(infix[i])) {
-                postfix += infix[i];
-                i++;
-            }
-            postfix += ' '; // space to separate numbers
-            i--;
+    int sp = 0;
+    for (const Instr &in : prog.code) {
+        switch (in.op) {
+            case OP_PUSH: st[sp++] = in.value; break;
+            case OP_LOAD: st[sp++] = vars ? vars[in.slot] : 0.0; break;
+            case OP_ADD: sp--; st[sp - 1] += st[sp]; break;
+            case OP_SUB: sp--; st[sp - 1] -= st[sp]; break;
+            case OP_MUL: sp--; st[sp - 1] *= st[sp]; break;
+            case OP_DIV: sp--; st[sp - 1] /= st[sp]; break;
+            case OP_POW: sp--; st[sp - 1] = pow(st[sp - 1], st[sp]); break;
+            case OP_NEG: st[sp - 1] = -st[sp - 1]; break;
+            case OP_STORE: temps[in.slot] = st[sp - 1]; break;
+            case OP_TEMP: st[sp++] = temps[in.slot]; break;
         }
-        else if (c == '(') {
-            st.push(c);
+    }
+    return st[0];
+}
+
+// ---------------- Optimizer ----------------
+// Runs between compilation and evaluation. The bytecode is lifted into a
+// hash-consed DAG, where identical subtrees share one node, and is then
+// simplified while the DAG is built:
+//   - constant folding           2^10        -> 1024, -(3) -> -3
+//   - dead-operand removal       x*1, x/1, x-0, x+(-0), x^1, --x -> x;  x^0 -> 1
+//   - common subexpressions      computed once, kept in a temp slot
+// Every rule gives the same bits as evaluatePostfix for every x, infinities,
+// NaN and -0 included. That rules out x*0 -> 0 (inf*0 is NaN), x+0 -> x
+// (-0+0 is +0) and x^2 -> x*x (pow is not always correctly rounded).
+
+struct DagNode {
+    OpCode op;      // OP_PUSH, OP_LOAD or an operator
+    int slot;
+    double value;
+    int lhs, rhs;   // rhs is -1 for OP_NEG
+};
+
+class Optimizer {
+private:
+    vector<DagNode> nodes;
+    map<tuple<int, int, uint64_t, int, int>, int> interned;
+    vector<int> uses;
+    vector<int> tempOf;
+    Program out;
+    int depth = 0;
+
+    int intern(OpCode op, int slot, double value, int lhs, int rhs) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof bits);
+        auto key = make_tuple(int(op), slot, bits, lhs, rhs);
+        auto it = interned.find(key);
+        if (it != interned.end()) return it->second;
+        nodes.push_back({op, slot, value, lhs, rhs});
+        interned[key] = int(nodes.size()) - 1;
+        return int(nodes.size()) - 1;
+    }
+
+    int constant(double v) { return intern(OP_PUSH, 0, v, -1, -1); }
+
+    bool isConst(int n, double v) const {
+        return nodes[n].op == OP_PUSH && nodes[n].value == v;
+    }
+
+    bool isZero(int n, bool negative) const {
+        return isConst(n, 0) && signbit(nodes[n].value) == negative;
+    }
+
+    int negate(int a) {
+        if (nodes[a].op == OP_PUSH) return constant(-nodes[a].value);
+        if (nodes[a].op == OP_NEG) return nodes[a].lhs;
+        return intern(OP_NEG, 0, 0.0, a, -1);
+    }
+
+    int binary(OpCode op, int a, int b) {
+        if (nodes[a].op == OP_PUSH && nodes[b].op == OP_PUSH) {
+            Program p;
+            p.code = {{OP_PUSH, 0, nodes[a].value}, {OP_PUSH, 0, nodes[b].value}, {op, 0, 0.0}};
+            p.maxDepth = 2;
+            return constant(runProgram(p, nullptr));
+        }
+        switch (op) {
+            case OP_ADD:
+                if (isZero(a, true)) return b;
+                if (isZero(b, true)) return a;
+                break;
+            case OP_SUB:
+                if (isZero(b, false)) return a;
+                break;
+            case OP_MUL:
+                if (isConst(a, 1)) return b;
+                if (isConst(b, 1)) return a;
+                break;
+            case OP_DIV:
+                if (isConst(b, 1)) return a;
+                break;
+            case OP_POW:
+                if (isConst(b, 0)) return constant(1);
+                if (isConst(b, 1)) return a;
+                break;
+            default:
+                break;
+        }
+        return intern(op, 0, 0.0, a, b);
+    }
+
+    // Both walks below use an explicit stack: a long chain such as
+    // a+a+...+a is a DAG as deep as the input is long.
+    void countUses(int root) {
+        vector<int> st{root};
+        while (!st.empty()) {
+            int n = st.back();
+            st.pop_back();
+            if (uses[n]++ > 0) continue;   // children already counted
+            if (nodes[n].lhs >= 0) st.push_back(nodes[n].lhs);
+            if (nodes[n].rhs >= 0) st.push_back(nodes[n].rhs);
         }
-        else if (c == ')') {
-            while (!st.empty() && st.top() != '(') {
-                postfix += st.top();
-                postfix += ' ';
-                st.pop();
+    }
+
+    void push(const Instr &in, int delta) {
+        out.code.push_back(in);
+        depth += delta;
+        out.maxDepth = max(out.maxDepth, depth);
+    }
+
+    // Post-order: operands, then the operator. stage counts the operands
+    // already emitted for each pending node.
+    void emit(int root) {
+        vector<pair<int, int>> st{{root, 0}};
+        while (!st.empty()) {
+            int n = st.back().first;
+            int stage = st.back().second++;
+            const DagNode &d = nodes[n];
+            if (stage == 0) {
+                if (d.op == OP_PUSH || d.op == OP_LOAD) {
+                    push({d.op, d.slot, d.value}, +1);   // leaves are cheaper to reload than to cache
+                    st.pop_back();
+                } else if (tempOf[n] >= 0) {
+                    push({OP_TEMP, tempOf[n], 0.0}, +1);
+                    st.pop_back();
+                } else {
+                    st.push_back({d.lhs, 0});
+                }
+                continue;
             }
-            if (!st.empty()) st.pop(); // remove '('
+            if (stage == 1 && d.rhs >= 0) {
+                st.push_back({d.rhs, 0});
+                continue;
+            }
+            push({d.op, 0, 0.0}, d.rhs >= 0 ? -1 : 0);
+            if (uses[n] > 1) {
+                tempOf[n] = out.numTemps++;
+                push({OP_STORE, tempOf[n], 0.0}, 0);
+            }
+            st.pop_back();
         }
-        else if (isOperator(c)) {
-            while (!st.empty() && precedence(st.top()) >= precedence(c)) {
-                postfix += st.top();
-                postfix += ' ';
-                st.pop();
+    }
+
+public:
+    Program run(const Program &prog) {
+        vector<int> st;
+        for (const Instr &in : prog.code) {
+            if (in.op == OP_PUSH || in.op == OP_LOAD) {
+                st.push_back(intern(in.op, in.slot, in.value, -1, -1));
+            } else if (in.op == OP_STORE || in.op == OP_TEMP) {
+                return prog;   // already optimized
+            } else if (in.op == OP_NEG) {
+                if (st.empty()) return prog;
+                st.back() = negate(st.back());
+            } else {
+                if (st.size() < 2) return prog;
+                int b = st.back(); st.pop_back();
+                int a = st.back(); st.pop_back();
+                st.push_back(binary(in.op, a, b));
             }
-            st.push(c);
         }
+        if (st.size() != 1) return prog;   // leave malformed programs untouched
+
+        uses.assign(nodes.size(), 0);
+        tempOf.assign(nodes.size(), -1);
+        countUses(st.back());
+        emit(st.back());
+        return out;
     }
+};
+
+Program optimizeProgram(const Program &prog) {
+    return Optimizer().run(prog);
+}
+
+// ---------------- Native fast path ----------------
+// Formulas known at build time can be written as expression templates,
+// e.g. (Var<'a'>() + Var<'b'>()) * Var<'c'>(). The compiler inlines the
+// whole tree into straight-line code. Every node type is empty, so a
+// formula's type alone is enough to evaluate it.
+
+template <char Name> struct Var {
+    double operator()(const double* v) const { return v[Name - 'a']; }
+};
+
+template <long N> struct Lit {
+    double operator()(const double*) const { return double(N); }
+};
 
-    // Pop remaining operators
-    while (!st.empty()) {
-        postfix += st.top();
-        postfix += ' ';
-        st.pop();
+template <char Op, class L, class R> struct BinExpr {
+    double operator()(const double* v) const {
+        double a = L{}(v), b = R{}(v);
+        if constexpr (Op == '+') return a + b;
+        else if constexpr (Op == '-') return a - b;
+        else if constexpr (Op == '*') return a * b;
+        else if constexpr (Op == '/') return a / b;
+        else return pow(a, b);
     }
+};
 
-    return postfix;
+template <class T> struct isExprNode : false_type {};
+template <char Name> struct isExprNode<Var<Name>> : true_type {};
+template <long N> struct isExprNode<Lit<N>> : true_type {};
+template <char Op, class L, class R> struct isExprNode<BinExpr<Op, L, R>> : true_type {};
+
+template <class L, class R>
+using enableExpr = enable_if_t<isExprNode<L>::value && isExprNode<R>::value, int>;
+
+template <class L, class R, enableExpr<L, R> = 0> BinExpr<'+', L, R> operator+(L, R) { return {}; }
+template <class L, class R, enableExpr<L, R> = 0> BinExpr<'-', L, R> operator-(L, R) { return {}; }
+template <class L, class R, enableExpr<L, R> = 0> BinExpr<'*', L, R> operator*(L, R) { return {}; }
+template <class L, class R, enableExpr<L, R> = 0> BinExpr<'/', L, R> operator/(L, R) { return {}; }
+// C++ '^' binds looser than '+', so power gets a named helper instead
+template <class L, class R, enableExpr<L, R> = 0> BinExpr<'^', L, R> power(L, R) { return {}; }
+
+using NativeFn = double (*)(const double*);
+
+template <class E> double nativeThunk(const double* v) {
+    return E{}(v);
 }
 
-// Evaluate Postfix Expression
-double evaluatePostfix(string postfix) {
-    stack<double> st;
-    string num = "";
+// Native formulas keyed by their postfix form
+unordered_map<string, NativeFn> &nativeRegistry() {
+    static unordered_map<string, NativeFn> registry;
+    return registry;
+}
 
-    for (size_t i = 0; i < postfix.length(); i++) {
-        char c = postfix[i];
+template <class E> void registerNative(const string &infix, E) {
+    nativeRegistry()[infixToPostfix(infix)] = &nativeThunk<E>;
+}
 
-        if (isdigit(c)) {
-            num = "";
-            while (i < postfix.length() && isdigit(postfix[i])) {
-                num += postfix[i];
-                i++;
+// Hot formulas of the rules engine
+void registerBuiltinNatives() {
+    registerNative("(a+b)*c", (Var<'a'>() + Var<'b'>()) * Var<'c'>());
+    registerNative("a*b+c", Var<'a'>() * Var<'b'>() + Var<'c'>());
+    registerNative("(a-b)/(a+b)", (Var<'a'>() - Var<'b'>()) / (Var<'a'>() + Var<'b'>()));
+    registerNative("a*x^2+b*x+c",
+                   Var<'a'>() * power(Var<'x'>(), Lit<2>()) + Var<'b'>() * Var<'x'>() + Var<'c'>());
+}
+
+// An expression ready for repeated evaluation: native code when the
+// formula was registered, the bytecode VM otherwise
+struct CompiledExpression {
+    Program program;
+    NativeFn native = nullptr;
+
+    // Without bindings (vars == nullptr, as in bulk mode) every variable
+    // reads 0. Native thunks index vars directly, so they need real ones.
+    double evaluate(const double* vars) const {
+        return native && vars ? native(vars) : runProgram(program, vars);
+    }
+};
+
+CompiledExpression compileExpression(const string &infix) {
+    CompiledExpression ce;
+    string postfix = infixToPostfix(infix);
+    ce.program = optimizeProgram(compilePostfix(postfix));
+    auto it = nativeRegistry().find(postfix);
+    if (it != nativeRegistry().end()) ce.native = it->second;
+    return ce;
+}
+
+// ---------------- Expression cache ----------------
+// LRU cache of compiled expressions keyed by the canonical expression
+// text, for workloads that submit the same formulas over and over. The
+// cache is split into shards, each with its own lock and LRU list, so
+// many request threads can share it without contending on a single mutex.
+// Memory is bounded by an approximate byte budget per shard.
+
+bool isOperandChar(char c) {
+    return isalnum((unsigned char)c) || c == '.';
+}
+
+bool isExponentChar(char c) {
+    return c == 'e' || c == 'E';
+}
+
+// Whether dropping the whitespace between key and next could merge two
+// tokens into one number: "1 2" into "12", "2e -3" into "2e-3" and
+// "2e- 3" into "2e-3" all lex differently once joined
+bool spaceIsSignificant(const string &key, char next) {
+    char last = key.back();
+    if (isOperandChar(last) && isOperandChar(next)) return true;
+    if (isExponentChar(last) && (next == '+' || next == '-')) return true;
+    return (last == '+' || last == '-') && key.size() >= 2 && isExponentChar(key[key.size() - 2]) &&
+           isdigit((unsigned char)next);
+}
+
+// Canonical key: the expression without whitespace, except for a single
+// space wherever removing it would change how the text lexes.
+string canonicalExpression(const string &infix) {
+    string key;
+    key.reserve(infix.size());
+    for (size_t i = 0; i < infix.size(); i++) {
+        if (!isSpaceChar(infix[i])) {
+            key += infix[i];
+            continue;
+        }
+        size_t j = i;
+        while (j < infix.size() && isSpaceChar(infix[j])) j++;
+        if (!key.empty() && j < infix.size() && spaceIsSignificant(key, infix[j])) key += ' ';
+        i = j - 1;
+    }
+    return key;
+}
+
+struct CachedExpression {
+    shared_ptr<const CompiledExpression> compiled;
+    bool isConstant = false;   // no variables: value is the final result
+    double value = 0.0;
+
+    double evaluate(const double* vars) const {
+        return isConstant ? value : compiled->evaluate(vars);
+    }
+};
+
+class ExpressionCache {
+private:
+    struct Shard {
+        mutex lock;
+        list<pair<string, CachedExpression>> lru;   // most recently used first
+        unordered_map<string, list<pair<string, CachedExpression>>::iterator> index;
+        size_t bytes = 0;
+        uint64_t hits = 0, misses = 0, evictions = 0;
+    };
+
+    vector<unique_ptr<Shard>> shards;
+    size_t shardBudget;
+
+    static size_t entryBytes(const string &key, const CachedExpression &e) {
+        // key copies in the list and the index, the program, and node overhead
+        return 2 * key.size() + e.compiled->program.code.size() * sizeof(Instr) + 160;
+    }
+
+    Shard &shardFor(const string &key) {
+        return *shards[hash<string>()(key) % shards.size()];
+    }
+
+public:
+    explicit ExpressionCache(size_t maxBytes = 64u << 20, size_t shardCount = 16)
+        : shardBudget(max<size_t>(maxBytes / max<size_t>(shardCount, 1), 1)) {
+        for (size_t i = 0; i < max<size_t>(shardCount, 1); i++) shards.emplace_back(new Shard);
+    }
+
+    // Compiled form of infix, compiling and inserting it on a miss
+    CachedExpression get(const string &infix) {
+        // most submissions are already canonical; skip the copy for them
+        if (none_of(infix.begin(), infix.end(), isSpaceChar)) return lookup(infix);
+        try {
+            return lookup(canonicalExpression(infix));
+        } catch (const ExpressionError &) {
+            // the error position refers to the key; report it in the caller's text
+            compileExpression(infix);
+            throw;
+        }
+    }
+
+    void clear() {
+        for (auto &sh : shards) {
+            lock_guard<mutex> g(sh->lock);
+            sh->lru.clear();
+            sh->index.clear();
+            sh->bytes = 0;
+        }
+    }
+
+    uint64_t hits() const { return sum(&Shard::hits); }
+    uint64_t misses() const { return sum(&Shard::misses); }
+    uint64_t evictions() const { return sum(&Shard::evictions); }
+
+    size_t bytes() const {
+        size_t total = 0;
+        for (auto &sh : shards) {
+            lock_guard<mutex> g(sh->lock);
+            total += sh->bytes;
+        }
+        return total;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (auto &sh : shards) {
+            lock_guard<mutex> g(sh->lock);
+            total += sh->lru.size();
+        }
+        return total;
+    }
+
+private:
+    CachedExpression lookup(const string &key) {
+        Shard &sh = shardFor(key);
+        {
+            lock_guard<mutex> g(sh.lock);
+            auto it = sh.index.find(key);
+            if (it != sh.index.end()) {
+                sh.hits++;
+                sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+                return it->second->second;
             }
-            st.push(stod(num));
-            i--; // step back
-        }
-        else if (isOperator(c)) {
-            double val2 = st.top(); st.pop();
-            double val1 = st.top(); st.pop();
-
-            switch (c) {
-                case '+': st.push(val1 + val2); break;
-                case '-': st.push(val1 - val2); break;
-                case '*': st.push(val1 * val2); break;
-                case '/': st.push(val1 / val2); break;
-                case '^': st.push(pow(val1, val2)); break;
+            sh.misses++;
+        }
+
+        // compile outside the lock so a slow compile does not block the shard
+        CachedExpression entry;
+        entry.compiled = make_shared<const CompiledExpression>(compileExpression(key));
+        const Program &prog = entry.compiled->program;
+        if (!entry.compiled->native && prog.code.size() == 1 && prog.code[0].op == OP_PUSH) {
+            entry.isConstant = true;
+            entry.value = prog.code[0].value;
+        }
+
+        lock_guard<mutex> g(sh.lock);
+        auto it = sh.index.find(key);
+        if (it != sh.index.end()) return it->second->second;   // another thread won the race
+
+        sh.lru.emplace_front(key, entry);
+        sh.index[key] = sh.lru.begin();
+        sh.bytes += entryBytes(key, entry);
+        while (sh.bytes > shardBudget && sh.lru.size() > 1) {
+            auto &victim = sh.lru.back();
+            sh.bytes -= entryBytes(victim.first, victim.second);
+            sh.index.erase(victim.first);
+            sh.lru.pop_back();
+            sh.evictions++;
+        }
+        return entry;
+    }
+
+    uint64_t sum(uint64_t Shard::*counter) const {
+        uint64_t total = 0;
+        for (auto &sh : shards) {
+            lock_guard<mutex> g(sh->lock);
+            total += (*sh).*counter;
+        }
+        return total;
+    }
+};
+
+// ---------------- Bulk evaluation ----------------
+// Service mode for files with millions of expressions, one per line.
+// Lines are cut into fixed-size chunks and dealt out to per-worker
+// deques. A worker takes chunks from the front of its own deque (in input
+// order) and steals from the back of another worker's deque when its own
+// runs dry. The calling thread acts as the writer: it waits for chunks in
+// input order and copies their output into a buffered writer.
+
+class BufferedWriter {
+private:
+    FILE* out;
+    vector<char> buf;
+    size_t used = 0;
+    bool failed = false;   // a short write, e.g. a full disk; sticky
+
+public:
+    explicit BufferedWriter(FILE* f, size_t capacity = 1 << 20) : out(f), buf(capacity) {}
+    ~BufferedWriter() { flush(); }
+
+    void write(string_view data) {
+        if (used + data.size() > buf.size()) flush();
+        if (data.size() > buf.size()) {
+            if (fwrite(data.data(), 1, data.size(), out) != data.size()) failed = true;
+            return;
+        }
+        memcpy(buf.data() + used, data.data(), data.size());
+        used += data.size();
+    }
+
+    // Returns false once any write so far has failed
+    bool flush() {
+        if (used && fwrite(buf.data(), 1, used, out) != used) failed = true;
+        used = 0;
+        if (fflush(out) != 0) failed = true;
+        return !failed;
+    }
+};
+
+struct BulkStats {
+    size_t lines = 0;
+    size_t errors = 0;
+};
+
+BulkStats bulkEvaluate(string_view input, BufferedWriter &writer, int threads, ExpressionCache &cache) {
+    const size_t chunkLines = 4096;
+
+    vector<string_view> lines;
+    for (size_t pos = 0; pos < input.size();) {
+        size_t end = input.find('\n', pos);
+        if (end == string_view::npos) end = input.size();
+        string_view line = input.substr(pos, end - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        lines.push_back(line);
+        pos = end + 1;
+    }
+
+    size_t numChunks = (lines.size() + chunkLines - 1) / chunkLines;
+    vector<string> output(numChunks);
+    vector<size_t> chunkErrors(numChunks, 0);
+    unique_ptr<atomic<bool>[]> done(new atomic<bool>[numChunks]);
+    for (size_t i = 0; i < numChunks; i++) done[i] = false;
+
+    struct ChunkQueue {
+        mutex lock;
+        deque<size_t> chunks;
+    };
+    threads = max(1, threads);
+    vector<unique_ptr<ChunkQueue>> queues;
+    for (int t = 0; t < threads; t++) queues.emplace_back(new ChunkQueue);
+    // contiguous ranges, so each worker naturally runs in input order
+    for (size_t i = 0; i < numChunks; i++) queues[i * threads / max<size_t>(numChunks, 1)]->chunks.push_back(i);
+
+    mutex doneLock;
+    condition_variable chunkDone;
+
+    auto takeChunk = [&](int self, size_t &chunk) {
+        for (int k = 0; k < threads; k++) {
+            ChunkQueue &q = *queues[(self + k) % threads];
+            lock_guard<mutex> g(q.lock);
+            if (q.chunks.empty()) continue;
+            if (k == 0) {
+                chunk = q.chunks.front();
+                q.chunks.pop_front();
+            } else {
+                chunk = q.chunks.back();   // steal the work furthest from the owner
+                q.chunks.pop_back();
+            }
+            return true;
+        }
+        return false;
+    };
+
+    auto worker = [&](int self) {
+        string expr;
+        size_t chunk;
+        while (takeChunk(self, chunk)) {
+            string &out = output[chunk];
+            size_t first = chunk * chunkLines;
+            size_t last = min(lines.size(), first + chunkLines);
+            for (size_t i = first; i < last; i++) {
+                expr.assign(lines[i].data(), lines[i].size());
+                try {
+                    appendNumber(out, cache.get(expr).evaluate(nullptr));
+                } catch (const ExpressionError &e) {
+                    out += "error at position " + to_string(e.position) + ": " + e.what();
+                    chunkErrors[chunk]++;
+                }
+                out += '\n';
             }
+            {
+                lock_guard<mutex> g(doneLock);
+                done[chunk] = true;
+            }
+            chunkDone.notify_all();
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(worker, t);
+
+    BulkStats stats;
+    stats.lines = lines.size();
+    for (size_t i = 0; i < numChunks; i++) {
+        {
+            unique_lock<mutex> g(doneLock);
+            chunkDone.wait(g, [&] { return done[i].load(); });
+        }
+        writer.write(output[i]);
+        string().swap(output[i]);
+        stats.errors += chunkErrors[i];
+    }
+    for (auto &t : pool) t.join();
+    writer.flush();
+    return stats;
+}
+
+bool readWholeFile(const string &path, string &contents) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char buf[1 << 16];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof buf, f)) > 0) contents.append(buf, n);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+int runBulk(const string &inPath, const string &outPath, int threads) {
+    string input;
+    if (!readWholeFile(inPath, input)) {
+        cout << "Cannot read " << inPath << "\n";
+        return 1;
+    }
+    FILE* out = fopen(outPath.c_str(), "wb");
+    if (!out) {
+        cout << "Cannot write " << outPath << "\n";
+        return 1;
+    }
+
+    ExpressionCache cache;
+    auto start = chrono::steady_clock::now();
+    BulkStats stats;
+    bool ok;
+    {
+        BufferedWriter writer(out);
+        stats = bulkEvaluate(input, writer, threads, cache);
+        ok = writer.flush();
+    }
+    ok = fclose(out) == 0 && ok;
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (!ok) {
+        cout << "Cannot write " << outPath << "\n";
+        return 1;
+    }
+
+    cout << "Evaluated " << stats.lines << " expressions (" << stats.errors << " errors) with "
+         << threads << " thread(s) in " << fixed << setprecision(3) << secs << " s\n";
+    return 0;
+}
+
+// ---------------- Benchmark ----------------
+
+template <class F> double nsPerOp(long iterations, F body) {
+    auto start = chrono::steady_clock::now();
+    double sink = 0;
+    double vars[26] = {0};
+    for (long i = 0; i < iterations; i++) {
+        vars[0] = double(i & 1023);
+        vars[1] = double(i & 255) + 1;
+        vars[2] = 3.0;
+        vars['x' - 'a'] = double(i & 63);
+        sink += body(vars);
+    }
+    auto end = chrono::steady_clock::now();
+    volatile double keep = sink;
+    (void)keep;
+    return chrono::duration<double, nano>(end - start).count() / iterations;
+}
+
+void benchmarkPaths(long iterations) {
+    const char* formulas[] = {"(a+b)*c", "a*b+c", "(a-b)/(a+b)", "a*x^2+b*x+c"};
+
+    cout << "Formula           interpreter     VM      native  (ns/op)\n";
+    for (const char* f : formulas) {
+        string postfix = infixToPostfix(f);
+        CompiledExpression ce = compileExpression(f);
+        Program prog = ce.program;
+
+        // the string interpreter is orders of magnitude slower, so give it fewer runs
+        double interp = nsPerOp(iterations / 100, [&](const double* v) { return evaluatePostfix(postfix, v); });
+        double vm = nsPerOp(iterations, [&](const double* v) { return runProgram(prog, v); });
+        double native = ce.native ? nsPerOp(iterations, [&](const double* v) { return ce.native(v); }) : 0.0;
+
+        cout << left << setw(16) << f << right << fixed << setprecision(2)
+             << setw(12) << interp << setw(8) << vm << setw(12) << native << "\n";
+    }
+}
+
+// Formulas taken from finance, physics and scoring rules
+const char* formulaCorpus[] = {
+    "p*(1+r/1200)^(12*t)",
+    "(9*c)/5+32",
+    "m*g*h+m*v^2/2",
+    "(a+b)^2-(a-b)^2",
+    "2^10*x+2^10*y",
+    "(x-m)^2/(2*s^2)",
+    "w*(1-0)+b*1+c*0",
+    "(a*b+c)*(a*b+c)+(a*b+c)",
+    "100*(n-o)/o",
+    "22/7*r^2",
+    "(1+2*3)^2*k+(1+2*3)^2*j",
+    "a*x^2+b*x+c",
+};
+
+void benchmarkOptimizer(long iterations) {
+    cout << "\nFormula                     instrs  before   after  (ns/op)  speedup\n";
+    double logSum = 0;
+    int count = 0;
+    for (const char* f : formulaCorpus) {
+        Program plain = compilePostfix(infixToPostfix(f));
+        Program opt = optimizeProgram(plain);
+
+        double before = nsPerOp(iterations, [&](const double* v) { return runProgram(plain, v); });
+        double after = nsPerOp(iterations, [&](const double* v) { return runProgram(opt, v); });
+
+        cout << left << setw(26) << f << right << setw(4) << plain.code.size() << "->"
+             << left << setw(3) << opt.code.size() << right << fixed << setprecision(2)
+             << setw(8) << before << setw(8) << after << setw(17) << before / after << "x\n";
+        logSum += log(before / after);
+        count++;
+    }
+    cout << "Geometric mean speedup: " << exp(logSum / count) << "x\n";
+}
+
+// Random well-formed infix expression over small integers and a..z
+string randomExpression(mt19937 &rng, int depth) {
+    if (depth == 0 || rng() % 4 == 0) {
+        if (rng() % 2) return string(1, char('a' + rng() % 26));
+        string num = to_string(rng() % 100);
+        if (rng() % 4 == 0) num += "." + to_string(rng() % 100);
+        return num;
+    }
+    const char ops[] = "+-*/^";
+    char op = ops[rng() % 5];
+    string lhs = randomExpression(rng, depth - 1);
+    if (rng() % 8 == 0) lhs = "-" + lhs;
+    string rhs = op == '^' ? to_string(rng() % 4) : randomExpression(rng, depth - 1);
+    string e = lhs + op + rhs;
+    return rng() % 2 ? "(" + e + ")" : e;
+}
+
+// Zipf-distributed request stream over a pool of distinct expressions
+void benchmarkCache(long requests, int threads) {
+    const size_t poolSize = 20000;
+    mt19937 rng(42);
+    vector<string> pool;
+    for (size_t i = 0; i < poolSize; i++) pool.push_back(randomExpression(rng, 4));
+
+    vector<double> weights(poolSize);
+    for (size_t i = 0; i < poolSize; i++) weights[i] = 1.0 / (i + 1);   // s = 1
+    discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+    vector<size_t> stream(requests);
+    for (auto &r : stream) r = zipf(rng);
+
+    ExpressionCache cache(8u << 20, 16);
+
+    // Per-request latency with and without the cache, split across threads
+    auto run = [&](bool cached) {
+        vector<vector<double>> latencies(threads);
+        vector<thread> workers;
+        auto start = chrono::steady_clock::now();
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                double vars[26];
+                for (int j = 0; j < 26; j++) vars[j] = j + 1;
+                double sink = 0;
+                for (long i = t; i < requests; i += threads) {
+                    auto t0 = chrono::steady_clock::now();
+                    const string &e = pool[stream[i]];
+                    if (cached) sink += cache.get(e).evaluate(vars);
+                    else sink += evaluatePostfix(infixToPostfix(e), vars);
+                    auto t1 = chrono::steady_clock::now();
+                    latencies[t].push_back(chrono::duration<double, nano>(t1 - t0).count());
+                }
+                volatile double keep = sink;
+                (void)keep;
+            });
+        }
+        for (auto &w : workers) w.join();
+        double wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        vector<double> all;
+        for (auto &l : latencies) all.insert(all.end(), l.begin(), l.end());
+        sort(all.begin(), all.end());
+        double mean = 0;
+        for (double x : all) mean += x;
+        mean /= all.size();
+        cout << (cached ? "cached   " : "uncached ") << fixed << setprecision(1)
+             << setw(10) << mean << setw(10) << all[all.size() / 2]
+             << setw(10) << all[all.size() * 99 / 100]
+             << setw(12) << setprecision(2) << requests / wall / 1e6 << "\n";
+        return mean;
+    };
+
+    cout << "Zipf workload: " << requests << " requests over " << poolSize
+         << " expressions, " << threads << " thread(s)\n";
+    cout << "path      mean(ns)   p50(ns)   p99(ns)  Mreq/s\n";
+    double slow = run(false);
+    double fast = run(true);
+    cout << "Mean latency improvement: " << setprecision(2) << slow / fast << "x\n";
+    cout << "hits " << cache.hits() << ", misses " << cache.misses()
+         << ", evictions " << cache.evictions() << ", entries " << cache.size()
+         << ", bytes " << cache.bytes() << "\n";
+}
+
+// Strong scaling of bulk mode from 1 thread up to every core
+void benchmarkBulk(long lines) {
+    mt19937 rng(7);
+    vector<string> pool;
+    for (int i = 0; i < 50000; i++) {
+        string e = randomExpression(rng, 5);
+        // bulk input carries no variable bindings
+        for (char &c : e) if (c >= 'a' && c <= 'z') c = char('1' + (c - 'a') % 9);
+        pool.push_back(e);
+    }
+    // registered native formulas too; their variables read 0 without bindings
+    const char* natives[] = {"(a+b)*c", "a*b+c", "(a-b)/(a+b)", "a*x^2+b*x+c"};
+    string input;
+    for (long i = 0; i < lines; i++) {
+        if (i % 64 == 0) {
+            input += natives[(i / 64) % 4];
+            input += '\n';
+            continue;
+        }
+        input += pool[rng() % pool.size()];
+        input += '\n';
+    }
+
+    int cores = max(1u, thread::hardware_concurrency());
+    vector<int> counts;
+    for (int t = 1; t < cores; t *= 2) counts.push_back(t);
+    counts.push_back(cores);
+
+    cout << "Bulk mode: " << lines << " lines, " << input.size() / 1e6 << " MB\n";
+    cout << "threads   seconds  Mlines/s  speedup\n";
+    double base = 0;
+    for (int t : counts) {
+        ExpressionCache cache;
+        FILE* sink = tmpfile();
+        auto start = chrono::steady_clock::now();
+        {
+            BufferedWriter writer(sink);
+            bulkEvaluate(input, writer, t, cache);
+        }
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        fclose(sink);
+        if (t == 1) base = secs;
+        cout << setw(7) << t << fixed << setprecision(3) << setw(10) << secs
+             << setw(10) << lines / secs / 1e6 << setw(8) << setprecision(2) << base / secs << "x\n";
+    }
+}
+
+// ---------------- Fuzz harness ----------------
+// Feeds random bytes, generated expressions and mutated expressions
+// through every path. Malformed input must come back as ExpressionError
+// and never crash. Well-formed input must give the same answer from the
+// interpreter, the VM and the optimized VM.
+
+bool sameResult(double a, double b) {
+    if (isnan(a) || isnan(b)) return isnan(a) && isnan(b);
+    if (isinf(a) || isinf(b)) return a == b;
+    return fabs(a - b) <= 1e-9 * max(1.0, max(fabs(a), fabs(b)));
+}
+
+// The optimizer must not change a single bit, -0 included
+bool identicalResult(double a, double b) {
+    if (isnan(a) || isnan(b)) return isnan(a) && isnan(b);
+    return memcmp(&a, &b, sizeof a) == 0;
+}
+
+string mutateExpression(mt19937 &rng, string e) {
+    const char alphabet[] = "0123456789.+-*/^()abexyz ~#E\t";
+    int edits = 1 + rng() % 3;
+    for (int k = 0; k < edits; k++) {
+        size_t at = e.empty() ? 0 : rng() % (e.size() + 1);
+        char c = alphabet[rng() % (sizeof alphabet - 1)];
+        // exponent fragments, with and without spaces around the sign
+        const char* exponents[] = {"e-", "e -", "e- ", "E+", "e +", " e+"};
+        switch (rng() % 4) {
+            case 0: e.insert(e.begin() + at, c); break;
+            case 1: if (at < e.size()) e.erase(at, 1); break;
+            case 2: if (at < e.size()) e[at] = c; break;
+            default: e.insert(at, exponents[rng() % 6]); break;
+        }
+    }
+    return e;
+}
+
+// Inputs far longer or deeper than randomExpression makes, to catch
+// anything that recurses once per token or per level
+vector<string> stressExpressions(mt19937 &rng) {
+    const size_t terms = 200000;
+    const char ops[] = "+-*/";
+    vector<string> out;
+    string chain = "a", right, nested;
+    for (size_t i = 1; i < 5 * terms; i++) {
+        chain += ops[rng() % 4];
+        chain += char('a' + rng() % 26);
+    }
+    out.push_back(chain);                                   // left-associative chain
+    string power = "1.5";
+    for (size_t i = 1; i < terms; i++) power += "^1";
+    out.push_back(power);                                   // right-associative chain
+    for (size_t i = 0; i < terms; i++) nested += '(';
+    nested += "x";
+    for (size_t i = 0; i < terms; i++) nested += ')';
+    out.push_back(nested);                                  // deep parentheses
+    for (size_t i = 0; i < terms / 2; i++) right += "b+(";
+    right += "c";
+    right.append(terms / 2, ')');
+    out.push_back(right);                                   // deep right operands
+    string spaced;
+    for (size_t i = 0; i < terms / 4; i++) spaced += "2e -3 + ";
+    spaced += "1";
+    out.push_back(spaced);                                  // long and malformed
+    out.push_back(string(terms, '('));                      // unmatched, all the way down
+    out.push_back(string(terms, '-') + "1");                // nested unary minus
+    return out;
+}
+
+int fuzzExpressions(long iterations, unsigned seed) {
+    mt19937 rng(seed);
+    double vars[26];
+    for (int j = 0; j < 26; j++) vars[j] = 1.5 * (j + 1);
+    ExpressionCache cache;
+
+    long rejected = 0, failures = 0;
+    size_t bytes = 0;
+    auto fail = [&](const string &input, const string &why) {
+        if (failures++ < 10) cout << "FAIL: " << why << " for \"" << input.substr(0, 60) << "\"\n";
+    };
+
+    // The cache must agree with a direct compile: same value, or the
+    // same error at the same position
+    auto checkCache = [&](const string &input) {
+        string direct, cached;
+        try {
+            double v = compileExpression(input).evaluate(vars);
+            appendNumber(direct, v);
+        } catch (const ExpressionError &e) {
+            direct = "error " + to_string(e.position) + ": " + e.what();
+        }
+        try {
+            double v = cache.get(input).evaluate(vars);
+            appendNumber(cached, v);
+        } catch (const ExpressionError &e) {
+            cached = "error " + to_string(e.position) + ": " + e.what();
         }
+        if (direct != cached) fail(input, "cache gave " + cached + ", direct compile " + direct);
+    };
+
+    auto check = [&](const string &input, bool wellFormed) {
+        bytes += input.size();
+        try {
+            string postfix = infixToPostfix(input);
+            Program plain = compilePostfix(postfix);
+            Program opt = optimizeProgram(plain);
+            double a = evaluatePostfix(postfix, vars);
+            double b = runProgram(plain, vars);
+            double c = runProgram(opt, vars);
+            if (!sameResult(a, b)) fail(input, "interpreter and VM disagree");
+            else if (!identicalResult(b, c)) fail(input, "optimizer changed the result");
+        } catch (const ExpressionError &e) {
+            rejected++;
+            if (wellFormed) fail(input, string("well-formed input rejected: ") + e.what());
+            if (e.position > input.size()) fail(input, "error position past end of input");
+        }
+        checkCache(input);
+    };
+
+    auto start = chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+        string input;
+        bool wellFormed = i % 3 == 1;
+        if (i % 3 == 0) {
+            // raw bytes, including control and non-ASCII characters
+            input.resize(rng() % 33);
+            for (char &c : input) c = char(rng() % 256);
+        } else {
+            input = randomExpression(rng, 1 + rng() % 5);
+            if (!wellFormed) input = mutateExpression(rng, input);
+        }
+        check(input, wellFormed);
     }
+    vector<string> stress = stressExpressions(rng);
+    for (size_t i = 0; i < stress.size(); i++) check(stress[i], i < 4);
 
-    return st.top();
+    // Rewrites that once changed IEEE results: inf*0, -0+0 and a pow that
+    // is not correctly rounded (b-b is 0 at run time, not a constant)
+    const char* regressions[] = {"a/(b-b)*0", "0*(a/(b-b))", "(a-b)/(b-b)*0", "-(a-a)+0", "0+-(a-a)",
+                                 "(a-a+9.2706403971540989e-60)^2"};
+    for (const char* input : regressions) check(input, true);
+    iterations += long(stress.size());
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Fuzzed " << iterations << " inputs (" << rejected << " rejected) in "
+         << fixed << setprecision(2) << secs << " s, " << iterations / secs / 1e6 << " M inputs/s\n";
+
+    // Parser throughput on valid input
+    vector<string> corpus;
+    size_t corpusBytes = 0;
+    for (int i = 0; i < 100000; i++) {
+        corpus.push_back(randomExpression(rng, 5));
+        corpusBytes += corpus.back().size();
+    }
+    start = chrono::steady_clock::now();
+    size_t sink = 0;
+    for (const string &e : corpus) sink += infixToPostfix(e).size();
+    secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    volatile size_t keep = sink;
+    (void)keep;
+    cout << "infixToPostfix throughput: " << corpusBytes / secs / 1e6 << " MB/s\n";
+
+    cout << (failures ? "FAILED: " : "OK: ") << failures << " failure(s)\n";
+    return failures ? 1 : 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    registerBuiltinNatives();
+
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        long iterations = argc > 2 ? atol(argv[2]) : 10000000;
+        benchmarkPaths(iterations);
+        benchmarkOptimizer(iterations);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-cache") {
+        long requests = argc > 2 ? atol(argv[2]) : 2000000;
+        int threads = argc > 3 ? atoi(argv[3]) : 1;
+        benchmarkCache(requests, max(threads, 1));
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-bulk") {
+        long lines = argc > 2 ? atol(argv[2]) : 2000000;
+        benchmarkBulk(lines);
+        return 0;
+    }
+    if (argc > 3 && string(argv[1]) == "--bulk") {
+        int threads = argc > 4 ? atoi(argv[4]) : int(thread::hardware_concurrency());
+        return runBulk(argv[2], argv[3], max(threads, 1));
+    }
+    if (argc > 1 && string(argv[1]) == "--fuzz") {
+        long iterations = argc > 2 ? atol(argv[2]) : 1000000;
+        unsigned seed = argc > 3 ? unsigned(atol(argv[3])) : 1;
+        return fuzzExpressions(iterations, seed);
+    }
+
     string infix;
-    cout << "Enter an infix expression (e.g., (3+5)*2): ";
+    cout << "Enter an infix expression (e.g., (3.5+5)*-2 or (a+b)*c): ";
     getline(cin, infix);
 
-    string postfix = infixToPostfix(infix);
-    cout << "Postfix Expression: " << postfix << endl;
+    try {
+        string postfix = infixToPostfix(infix);
+        cout << "Postfix Expression: " << postfix << endl;
+
+        // Ask for the value of every variable used
+        double vars[26] = {0};
+        bool asked[26] = {false};
+        Lexer lex(postfix, true);
+        for (Token t = lex.next(); t.kind != TOK_END; t = lex.next()) {
+            if (t.kind == TOK_VARIABLE && !asked[t.op - 'a']) {
+                cout << "Enter value for " << t.op << ": ";
+                cin >> vars[t.op - 'a'];
+                asked[t.op - 'a'] = true;
+            }
+        }
 
-    double result = evaluatePostfix(postfix);
-    cout << "Result: " << result << endl;
+        double result = compileExpression(infix).evaluate(vars);
+        cout << "Result: " << result << endl;
+    } catch (const ExpressionError &e) {
+        cout << "Error at position " << e.position << ": " << e.what() << endl;
+        cout << "  " << infix << "\n  " << string(e.position, ' ') << "^" << endl;
+        return 1;
+    }
 
     return 0;
 }
@@ -1,19 +1,60 @@
 #include <iostream>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include "numeric.h"
 using namespace std;
-int fact(int n){
-    if(n==1){
-        return 1;
-    }
-    else {
-       return n*fact(n-1);
+
+template <class F> double secondsFor(F body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// n! one factor at a time, the shape of the old recursive version
+BigInt factorialLinear(uint64_t n) {
+    BigInt acc = 1;
+    for (uint64_t k = 2; k <= n; k++) acc.mulSmall(k);
+    return acc;
+}
+
+void benchmarkFactorial(unsigned threads) {
+    cout << fixed << setprecision(3);
+    for (uint64_t n : {100000ull, 1000000ull}) {
+        BigInt one, many;
+        double seq = secondsFor([&] { one = factorial(n, 1); });
+        double par = secondsFor([&] { many = factorial(n, threads); });
+        cout << n << "! has " << one.bitLength() << " bits\n";
+        cout << "  product tree, 1 thread     " << setw(8) << seq << " s\n";
+        cout << "  product tree, " << threads << " threads" << string(threads < 10 ? 4 : 3, ' ')
+             << setw(8) << par << " s  (" << (one == many ? "same value" : "MISMATCH") << ")\n";
+        if (n <= 100000) {
+            BigInt slow;
+            double lin = secondsFor([&] { slow = factorialLinear(n); });
+            cout << "  one factor at a time       " << setw(8) << lin << " s  ("
+                 << (slow == one ? "same value" : "MISMATCH") << ")\n";
+        }
     }
 }
-int main() {
-    int n;
-    
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        unsigned threads = argc > 2 ? unsigned(atoi(argv[2])) : max(2u, thread::hardware_concurrency());
+        benchmarkFactorial(max(threads, 1u));
+        return 0;
+    }
+
+    long long n;
+
     cin >> n;
-    
- int ans =   fact(n);
- cout << ans;
+
+    if (!cin || n < 0) {
+        cout << "factorial is only defined for non-negative integers";
+        return 1;
+    }
+    cout << factorial(uint64_t(n)).toString();
 
 }
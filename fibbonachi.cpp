@@ -1,6 +1,12 @@
 #include <iostream>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include "numeric.h"
 using namespace std;
-   
+
+   // The original exponential version, kept as the benchmark baseline
    int fib(int num){
        if (num==0){
            return 0;
@@ -10,16 +16,64 @@ using namespace std;
        }
          else {
              return fib(num-1)+fib(num-2);
-         }  
-       
+         }
+
    }
-int main() {
+
+template <class F> double secondsFor(F body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkFibonacci(uint64_t n) {
+    cout << fixed << setprecision(6);
+    cout << "F(n) for small n, seconds per call\n";
+    cout << "   n   recursive   fast doubling (BigInt)\n";
+    for (int k : {20, 25, 30, 35}) {
+        volatile int slow = 0;
+        BigInt fast;
+        double a = secondsFor([&] { slow = fib(k); });
+        double b = secondsFor([&] { fast = fibonacci(uint64_t(k)); });
+        cout << setw(4) << k << setw(12) << a << setw(16) << b
+             << (fast == BigInt(slow) ? "" : "  MISMATCH") << "\n";
+    }
+
+    BigInt f;
+    double doubling = secondsFor([&] { f = fibonacci(n); });
+    size_t bits = f.bitLength();
+    cout << setprecision(3) << "F(" << n << "): " << bits << " bits\n";
+    cout << "  fast doubling        " << setw(9) << doubling << " s\n";
+
+    BigInt last;
+    double generated = secondsFor([&] {
+        forEachFibonacci(size_t(n) + 1, [&](size_t i, const BigInt &v) {
+            if (i == n) last = v;
+        });
+    });
+    cout << "  O(n) generator       " << setw(9) << generated << " s  ("
+         << (last == f ? "same value" : "MISMATCH") << ")\n";
+
+    string digits;
+    double print = secondsFor([&] { digits = f.toString(); });
+    cout << "  to decimal           " << setw(9) << print << " s  (" << digits.size() << " digits, "
+         << digits.substr(0, 20) << "...)\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        uint64_t n = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+        benchmarkFibonacci(n);
+        return 0;
+    }
+
     int num ;
     cout << "ener the number for fibboanachi series ::";
      cin >> num;
-     for (int i=0; i<num;i++){
-         cout << fib(i)<<" ";
-     }
+     // one addition per term, exact past F(47) where int overflows
+     forEachFibonacci(num > 0 ? size_t(num) : 0, [](size_t, const BigInt &f) {
+         cout << f.toString() << " ";
+     });
 
     return 0;
 }
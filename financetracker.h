@@ -0,0 +1,175 @@
+#ifndef FINANCETRACKER_H
+#define FINANCETRACKER_H
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "stats.h"
+
+// Compiled in only with -DHOTPATH_STATS, see stats.h
+STATS_HISTOGRAM(financeSearchRows, "finance_search_rows_scanned", "Transactions scanned per searchTransactions call")
+STATS_COUNTER(financeSearchMatches, "finance_search_matches", "Transactions printed by searchTransactions")
+STATS_HISTOGRAM(financeSearchLatency, "finance_search_latency_ns", "searchTransactions latency in nanoseconds, with output")
+STATS_HISTOGRAM(financeReportRows, "finance_report_rows_scanned", "Transactions scanned per monthlyReport call")
+STATS_COUNTER(financeReportBadDates, "finance_report_bad_dates", "Transactions monthlyReport skipped for a bad date")
+STATS_HISTOGRAM(financeReportLatency, "finance_report_latency_ns", "monthlyReport latency in nanoseconds, with output")
+STATS_HISTOGRAM(financeSortLatency, "finance_sort_latency_ns", "sortTransactions latency in nanoseconds")
+STATS_COUNTER(financeLoadRows, "finance_load_rows", "Transactions read by loadFromFile")
+STATS_HISTOGRAM(financeLoadLatency, "finance_load_latency_ns", "loadFromFile latency in nanoseconds")
+
+struct Transaction {
+    std::string date;       // format: YYYY-MM-DD
+    std::string type;       // Income / Expense
+    std::string description;
+    float amount;
+};
+
+class FinanceTracker {
+private:
+    std::vector<Transaction> transactions;
+
+public:
+    void addTransaction() {
+        Transaction t;
+        std::cout << "Enter date (YYYY-MM-DD): ";
+        std::cin >> t.date;
+        std::cout << "Enter type (Income/Expense): ";
+        std::cin >> t.type;
+        std::cin.ignore();
+        std::cout << "Enter description: ";
+        std::getline(std::cin, t.description);
+        std::cout << "Enter amount: ";
+        std::cin >> t.amount;
+
+        transactions.push_back(t);
+        std::cout << "Transaction added successfully!\n";
+    }
+
+    void addTransaction(const Transaction &t) {
+        transactions.push_back(t);
+    }
+
+    size_t size() const {
+        return transactions.size();
+    }
+
+    void viewTransactions() {
+        if (transactions.empty()) {
+            std::cout << "No transactions found.\n";
+            return;
+        }
+
+        std::cout << "\n--- All Transactions ---\n";
+        for (size_t i = 0; i < transactions.size(); i++) {
+            std::cout << i + 1 << ". Date: " << transactions[i].date
+                 << " | Type: " << transactions[i].type
+                 << " | Amount: " << std::fixed << std::setprecision(2) << transactions[i].amount
+                 << " | Description: " << transactions[i].description << "\n";
+        }
+    }
+
+    void searchTransactions() {
+        float limit;
+        std::cout << "Enter amount limit to search (e.g., 100): ";
+        std::cin >> limit;
+        searchTransactions(limit);
+    }
+
+    void searchTransactions(float limit) {
+        STATS_TIME_SCOPE(financeSearchLatency);
+        STATS_OBSERVE(financeSearchRows, transactions.size());
+        std::cout << "\n--- Transactions above " << limit << " ---\n";
+        for (auto &t : transactions) {
+            if (t.amount > limit) {
+                STATS_ADD(financeSearchMatches, 1);
+                std::cout << "Date: " << t.date
+                     << " | Type: " << t.type
+                     << " | Amount: " << t.amount
+                     << " | Desc: " << t.description << "\n";
+            }
+        }
+    }
+
+    void sortTransactions() {
+        STATS_TIME_SCOPE(financeSortLatency);
+        std::sort(transactions.begin(), transactions.end(),
+             [](Transaction &a, Transaction &b) {
+                 return a.amount < b.amount;
+             });
+        std::cout << "Transactions sorted by amount!\n";
+    }
+
+    void saveToFile(const std::string &path = "finance.dat") {
+        std::ofstream fout(path);
+        if (!fout) {
+            std::cout << "Error saving file!\n";
+            return;
+        }
+        for (auto &t : transactions) {
+            fout << t.date << "|" << t.type << "|" << t.amount << "|" << t.description << "\n";
+        }
+        fout.close();
+        std::cout << "Data saved successfully!\n";
+    }
+
+    void loadFromFile(const std::string &path = "finance.dat") {
+        STATS_TIME_SCOPE(financeLoadLatency);
+        std::ifstream fin(path);
+        if (!fin) {
+            std::cout << "No saved data found!\n";
+            return;
+        }
+        transactions.clear();
+        std::string line;
+        while (std::getline(fin, line)) {
+            std::stringstream ss(line);
+            Transaction t;
+            std::string amt;
+            std::getline(ss, t.date, '|');
+            std::getline(ss, t.type, '|');
+            std::getline(ss, amt, '|');
+            std::getline(ss, t.description, '|');
+            t.amount = std::stof(amt);
+            transactions.push_back(t);
+        }
+        fin.close();
+        STATS_ADD(financeLoadRows, transactions.size());
+        std::cout << "Data loaded successfully!\n";
+    }
+
+    void monthlyReport() {
+        STATS_TIME_SCOPE(financeReportLatency);
+        STATS_OBSERVE(financeReportRows, transactions.size());
+        float monthSum[13] = {0};
+        size_t badDates = 0;
+
+        for (auto &t : transactions) {
+            // a date without a month in 1..12 would index outside monthSum
+            int month = 0;
+            if (sscanf(t.date.c_str(), "%*d-%d-%*d", &month) != 1 || month < 1 || month > 12) {
+                badDates++;
+                continue;
+            }
+            monthSum[month] += t.amount;
+        }
+        STATS_ADD(financeReportBadDates, badDates);
+
+        std::cout << "\n--- Monthly Spending Report ---\n";
+        for (int m = 1; m <= 12; m++) {
+            if (monthSum[m] > 0) {
+                std::cout << "Month " << std::setw(2) << m << " : ";
+                int stars = (int)(monthSum[m] / 100); // 1 star = 100 units
+                for (int k = 0; k < stars; k++) std::cout << "*";
+                std::cout << " (" << std::fixed << std::setprecision(2) << monthSum[m] << ")\n";
+            }
+        }
+        if (badDates) std::cout << "Skipped " << badDates << " transaction(s) without a valid YYYY-MM-DD date.\n";
+    }
+};
+
+#endif
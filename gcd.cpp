@@ -1,21 +1,106 @@
 #include <iostream>
+#include <vector>
+#include <string>
+#include <numeric>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include "numeric.h"
 using namespace std;
 
+// The original recursive Euclid, kept as the benchmark baseline
 int  gcdval(int a, int b){
     if(b==0){
         return a;
     }
     else{
        return  gcdval(b,a%b);
-        
+
+    }
+
+    }
+
+template <class F> double secondsFor(F body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Euclid on 128 bits, for comparison: std::gcd needs a standard integer type
+unsigned __int128 euclid128(unsigned __int128 a, unsigned __int128 b) {
+    while (b != 0) {
+        unsigned __int128 r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+void benchmarkGcd(size_t n) {
+    mt19937_64 rng(17);
+    vector<uint32_t> a32(n), b32(n), out32(n);
+    vector<uint64_t> a64(n), b64(n);
+    vector<unsigned __int128> a128(n), b128(n);
+    for (size_t i = 0; i < n; i++) {
+        a32[i] = uint32_t(rng() >> 33);   // below 2^31, so gcdval's int is fine
+        b32[i] = uint32_t(rng() >> 33);
+        a64[i] = rng();
+        b64[i] = rng();
+        a128[i] = (unsigned __int128)rng() << 64 | rng();
+        b128[i] = (unsigned __int128)rng() << 64 | rng();
     }
-    
+
+    uint64_t check[4] = {0, 0, 0, 0};
+    auto row = [&](const char* name, double secs, size_t count, uint64_t sum, uint64_t expected) {
+        cout << "  " << left << setw(26) << name << right << fixed << setprecision(2) << setw(8)
+             << secs * 1e9 / count << " ns" << (sum == expected ? "" : "  MISMATCH") << "\n";
+    };
+
+    cout << n << " random pairs\n32-bit\n";
+    double t = secondsFor([&] { for (size_t i = 0; i < n; i++) check[0] += uint64_t(gcdval(int(a32[i]), int(b32[i]))); });
+    row("gcdval (recursive Euclid)", t, n, check[0], check[0]);
+    t = secondsFor([&] { for (size_t i = 0; i < n; i++) check[1] += gcd(a32[i], b32[i]); });
+    row("std::gcd", t, n, check[1], check[0]);
+    t = secondsFor([&] { for (size_t i = 0; i < n; i++) check[2] += binaryGcd(a32[i], b32[i]); });
+    row("binaryGcd", t, n, check[2], check[0]);
+    t = secondsFor([&] { gcdBatch(a32.data(), b32.data(), out32.data(), n); });
+    for (uint32_t g : out32) check[3] += g;
+#if defined(__AVX2__)
+    row("gcdBatch (AVX2, 8 lanes)", t, n, check[3], check[0]);
+#else
+    row("gcdBatch (scalar build)", t, n, check[3], check[0]);
+#endif
+
+    cout << "64-bit\n";
+    uint64_t s1 = 0, s2 = 0;
+    t = secondsFor([&] { for (size_t i = 0; i < n; i++) s1 += gcd(a64[i], b64[i]); });
+    row("std::gcd", t, n, s1, s1);
+    t = secondsFor([&] { for (size_t i = 0; i < n; i++) s2 += binaryGcd(a64[i], b64[i]); });
+    row("binaryGcd", t, n, s2, s1);
+
+    cout << "128-bit\n";
+    s1 = s2 = 0;
+    t = secondsFor([&] { for (size_t i = 0; i < n; i++) s1 += uint64_t(euclid128(a128[i], b128[i])); });
+    row("Euclid", t, n, s1, s1);
+    t = secondsFor([&] { for (size_t i = 0; i < n; i++) s2 += uint64_t(binaryGcd(a128[i], b128[i])); });
+    row("binaryGcd", t, n, s2, s1);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 10000000;
+        benchmarkGcd(n);
+        return 0;
     }
 
-int main() {
     int a = 12;
     int b= 18;
-    
-   int c= gcdval(a,b);
+
+   uint32_t c= binaryGcd(uint32_t(a), uint32_t(b));
    cout << c;
+
+   long long x, y;
+   extendedGcd<long long>(a, b, x, y);
+   cout << " = " << a << "*" << x << " + " << b << "*" << y << ", lcm " << binaryLcm(uint32_t(a), uint32_t(b)) << endl;
 }
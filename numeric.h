@@ -0,0 +1,242 @@
+#ifndef NUMERIC_H
+#define NUMERIC_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "bigint.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ---------------- Fibonacci ----------------
+// Fast doubling: from (F(k), F(k+1)),
+//   F(2k)   = F(k) * (2 F(k+1) - F(k))
+//   F(2k+1) = F(k)^2 + F(k+1)^2
+// so the bits of n, read from the top, reach F(n) in O(log n) steps.
+// With big integers the cost is that of the last few multiplications.
+
+// Exact for n <= 93; F(94) does not fit in 64 bits
+inline uint64_t fibonacci64(unsigned n) {
+    uint64_t a = 0, b = 1;   // F(k), F(k+1)
+    for (int bit = 31; bit >= 0; bit--) {
+        uint64_t c = a * (2 * b - a);
+        uint64_t d = a * a + b * b;
+        if (n >> bit & 1) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+inline BigInt fibonacci(uint64_t n) {
+    BigInt a = 0, b = 1;
+    int top = n ? 63 - __builtin_clzll(n) : -1;
+    for (int bit = top; bit >= 0; bit--) {
+        BigInt twoB = b + b;
+        BigInt c = a * (twoB - a);
+        BigInt d = a * a + b * b;
+        if (n >> bit & 1) {
+            a = std::move(d);
+            b = a + c;
+        } else {
+            a = std::move(c);
+            b = std::move(d);
+        }
+    }
+    return a;
+}
+
+// Calls visit(i, F(i)) for i = 0..count-1 with one addition per term
+template <class Visit>
+void forEachFibonacci(size_t count, Visit visit) {
+    BigInt a = 0, b = 1;
+    for (size_t i = 0; i < count; i++) {
+        visit(i, static_cast<const BigInt &>(a));
+        a += b;
+        std::swap(a, b);
+    }
+}
+
+// ---------------- Factorial ----------------
+// n! as a balanced product tree: the range 1..n is halved until the
+// pieces are small, and each level multiplies operands of similar size,
+// which is where Karatsuba pays off. Multiplying the factors one by one
+// instead always multiplies a huge number by a tiny one: O(n^2).
+
+// Product of lo..hi. Small ranges pack as many factors as fit into one
+// 64-bit word before touching the big number. Any hi, up to UINT64_MAX.
+inline BigInt rangeProduct(uint64_t lo, uint64_t hi) {
+    if (lo > hi) return 1;
+    if (lo == 0) return 0;
+    if (hi - lo < 64) {
+        BigInt acc = 1;
+        uint64_t word = 1;
+        for (uint64_t k = lo;; k++) {   // k <= hi would never fail for hi == UINT64_MAX
+            if (word > UINT64_MAX / k) {
+                acc.mulSmall(word);
+                word = 1;
+            }
+            word *= k;
+            if (k == hi) break;
+        }
+        return acc.mulSmall(word);
+    }
+    uint64_t mid = lo + (hi - lo) / 2;
+    return rangeProduct(lo, mid) * rangeProduct(mid + 1, hi);
+}
+
+// Like rangeProduct, but the top log2(threads) levels hand one half to
+// a new thread. The final multiplications are single-threaded, so the
+// speedup is bounded by how much of the time the lower levels take.
+inline BigInt parallelRangeProduct(uint64_t lo, uint64_t hi, unsigned threads) {
+    if (threads <= 1 || lo == 0 || hi < lo || hi - lo < 4096) return rangeProduct(lo, hi);
+    uint64_t mid = lo + (hi - lo) / 2;
+    BigInt left;
+    std::thread worker([&] { left = parallelRangeProduct(lo, mid, threads / 2); });
+    BigInt right = parallelRangeProduct(mid + 1, hi, threads - threads / 2);
+    worker.join();
+    return left * right;
+}
+
+inline BigInt factorial(uint64_t n, unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+    return n < 2 ? BigInt(1) : parallelRangeProduct(2, n, threads);
+}
+
+// ---------------- GCD ----------------
+// Binary (Stein) GCD: strip the common factors of two once with
+// count-trailing-zeros, then repeatedly replace the larger odd value by
+// the odd part of the difference. Only shifts and subtractions, no
+// division, and the loop body has no unpredictable branches. Works for
+// uint32_t, uint64_t and unsigned __int128.
+
+inline int countTrailingZeros(uint32_t x) { return __builtin_ctz(x); }
+inline int countTrailingZeros(uint64_t x) { return __builtin_ctzll(x); }
+inline int countTrailingZeros(unsigned __int128 x) {
+    uint64_t low = uint64_t(x);
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(uint64_t(x >> 64));
+}
+
+template <class U>
+U binaryGcd(U a, U b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    int shift = countTrailingZeros(a | b);
+    a >>= countTrailingZeros(a);
+    int bz = countTrailingZeros(b);
+    while (true) {
+        b >>= bz;
+        // b - a and |b - a| have the same trailing zeros, so the next
+        // shift is computed alongside min and abs instead of after them
+        U diff = b - a;
+        if (diff == 0) break;
+        bz = countTrailingZeros(diff);
+        U lo = std::min(a, b);
+        b = a < b ? diff : a - b;
+        a = lo;
+    }
+    return a << shift;
+}
+
+// Least common multiple, 0 if either input is 0. When the result does not
+// fit in U it wraps modulo 2^bits without notice; see checkedLcm.
+template <class U>
+U binaryLcm(U a, U b) {
+    if (a == 0 || b == 0) return 0;
+    return a / binaryGcd(a, b) * b;
+}
+
+// Like binaryLcm, but returns false instead of wrapping when the result
+// does not fit in U
+template <class U>
+bool checkedLcm(U a, U b, U &out) {
+    if (a == 0 || b == 0) {
+        out = 0;
+        return true;
+    }
+    return !__builtin_mul_overflow(a / binaryGcd(a, b), b, &out);
+}
+
+// gcd(a, b) = a*x + b*y for signed S (int32_t, int64_t or __int128),
+// by iterative extended Euclid. The result is non-negative.
+template <class S>
+S extendedGcd(S a, S b, S &x, S &y) {
+    S x0 = 1, y0 = 0, x1 = 0, y1 = 1;
+    while (b != 0) {
+        S q = a / b;
+        S r = a - q * b;
+        a = b;
+        b = r;
+        S t = x0 - q * x1;
+        x0 = x1;
+        x1 = t;
+        t = y0 - q * y1;
+        y0 = y1;
+        y1 = t;
+    }
+    if (a < 0) {
+        a = -a;
+        x0 = -x0;
+        y0 = -y0;
+    }
+    x = x0;
+    y = y0;
+    return a;
+}
+
+// out[i] = gcd(a[i], b[i]) over whole arrays
+template <class U>
+void gcdBatch(const U* a, const U* b, U* out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = binaryGcd(a[i], b[i]);
+}
+
+#if defined(__AVX2__)
+// Eight 32-bit lanes run Stein's loop in lockstep until every lane is
+// done. AVX2 has no vector ctz: x & -x isolates the lowest set bit, and
+// converting that power of two to float puts its index in the exponent.
+inline __m256i countTrailingZeros8(__m256i x) {
+    __m256i low = _mm256_and_si256(x, _mm256_sub_epi32(_mm256_setzero_si256(), x));
+    __m256i bits = _mm256_castps_si256(_mm256_cvtepi32_ps(low));
+    __m256i exponent = _mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xFF));
+    return _mm256_sub_epi32(exponent, _mm256_set1_epi32(127));
+}
+
+template <>
+inline void gcdBatch<uint32_t>(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        // gcd(0, y) = gcd(y, y): keeps zero lanes from spinning
+        __m256i zero = _mm256_setzero_si256();
+        __m256i xz = _mm256_cmpeq_epi32(x, zero), yz = _mm256_cmpeq_epi32(y, zero);
+        x = _mm256_blendv_epi8(x, y, xz);
+        y = _mm256_blendv_epi8(y, x, yz);
+
+        __m256i shift = countTrailingZeros8(_mm256_or_si256(x, y));
+        x = _mm256_srlv_epi32(x, countTrailingZeros8(x));
+        while (!_mm256_testz_si256(y, y)) {
+            // finished lanes (y == 0) must keep x; their ctz is bogus,
+            // but shifting 0 gives 0
+            __m256i done = _mm256_cmpeq_epi32(y, zero);
+            y = _mm256_srlv_epi32(y, countTrailingZeros8(y));
+            __m256i lo = _mm256_min_epu32(x, y);
+            y = _mm256_andnot_si256(done, _mm256_sub_epi32(_mm256_max_epu32(x, y), lo));
+            x = _mm256_blendv_epi8(lo, x, done);
+        }
+        // both inputs zero: the shift is bogus, but the lane is 0 anyway
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_sllv_epi32(x, shift));
+    }
+    for (; i < n; i++) out[i] = binaryGcd(a[i], b[i]);
+}
+#endif
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef PERSISTENTAVL_H
+#define PERSISTENTAVL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "traversal.h"
+
+// Persistent (copy-on-write) ordered map on an AVL tree. Nodes are never
+// changed once built: an update copies only the O(log n) nodes on its
+// path, plus the ones rotations touch, and shares every other subtree
+// with the previous version. Copying the map is O(1) and yields a
+// snapshot that stays readable, unchanged, while the original keeps
+// taking updates.
+//
+// Nodes are reference counted, so a node is freed as soon as no version
+// reaches it. The counts are atomic: a snapshot copied on the writer's
+// thread can be handed to reader threads and read or dropped there.
+// A single map object is not safe to update and read at once.
+template <class Key, class Value, class Compare = std::less<Key>>
+class PersistentAVLMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+private:
+    struct Node {
+        value_type kv;
+        const Node* left;
+        const Node* right;
+        int height;
+        mutable std::atomic<unsigned> refs{1};
+
+        Node(const value_type &p, const Node* l, const Node* r)
+            : kv(p), left(l), right(r), height(1 + std::max(getHeight(l), getHeight(r))) {
+            live.fetch_add(1, std::memory_order_relaxed);
+        }
+        ~Node() { live.fetch_sub(1, std::memory_order_relaxed); }
+    };
+
+    static inline std::atomic<size_t> live{0};
+
+    const Node* root = nullptr;
+    size_t count = 0;
+    Compare less;
+
+    static int getHeight(const Node* n) { return n ? n->height : 0; }
+
+    static const Node* retain(const Node* n) {
+        if (n) n->refs.fetch_add(1, std::memory_order_relaxed);
+        return n;
+    }
+
+    // Drops one reference; frees every node that becomes unreachable,
+    // without recursion
+    static void release(const Node* n) {
+        std::vector<const Node*> dead;
+        if (n && n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) dead.push_back(n);
+        while (!dead.empty()) {
+            const Node* d = dead.back();
+            dead.pop_back();
+            for (const Node* c : {d->left, d->right}) {
+                if (c && c->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) dead.push_back(c);
+            }
+            delete d;
+        }
+    }
+
+    // New node owning the references l and r, rotated back into balance.
+    // Nodes are immutable, so a rotation builds new nodes too.
+    static const Node* balance(const value_type &kv, const Node* l, const Node* r) {
+        int factor = getHeight(l) - getHeight(r);
+        if (factor > 1) {
+            const Node* out;
+            if (getHeight(l->left) >= getHeight(l->right)) {
+                out = new Node(l->kv, retain(l->left), new Node(kv, retain(l->right), r));
+            } else {
+                const Node* lr = l->right;
+                out = new Node(lr->kv, new Node(l->kv, retain(l->left), retain(lr->left)),
+                               new Node(kv, retain(lr->right), r));
+            }
+            release(l);
+            return out;
+        }
+        if (factor < -1) {
+            const Node* out;
+            if (getHeight(r->right) >= getHeight(r->left)) {
+                out = new Node(r->kv, new Node(kv, l, retain(r->left)), retain(r->right));
+            } else {
+                const Node* rl = r->left;
+                out = new Node(rl->kv, new Node(kv, l, retain(rl->left)),
+                               new Node(r->kv, retain(rl->right), retain(r->right)));
+            }
+            release(r);
+            return out;
+        }
+        return new Node(kv, l, r);
+    }
+
+    // The subtree n with (key, value) added, as a new reference. n is only
+    // borrowed. Recursion depth is the tree height.
+    template <bool Overwrite>
+    const Node* insertInto(const Node* n, const Key &key, const Value &value, bool &inserted) const {
+        if (!n) {
+            inserted = true;
+            return new Node(value_type(key, value), nullptr, nullptr);
+        }
+        if (less(key, n->kv.first)) {
+            const Node* l = insertInto<Overwrite>(n->left, key, value, inserted);
+            if (!l) return nullptr;
+            return balance(n->kv, l, retain(n->right));
+        }
+        if (less(n->kv.first, key)) {
+            const Node* r = insertInto<Overwrite>(n->right, key, value, inserted);
+            if (!r) return nullptr;
+            return balance(n->kv, retain(n->left), r);
+        }
+        // present: copy only if the value changes; nullptr means "no change"
+        if (!Overwrite) return nullptr;
+        return new Node(value_type(key, value), retain(n->left), retain(n->right));
+    }
+
+    // n without its smallest node, which is stored in min
+    static const Node* eraseMin(const Node* n, const Node* &min) {
+        if (!n->left) {
+            min = n;
+            return retain(n->right);
+        }
+        return balance(n->kv, eraseMin(n->left, min), retain(n->right));
+    }
+
+    // n without key, which must be present
+    const Node* eraseFrom(const Node* n, const Key &key) const {
+        if (less(key, n->kv.first)) return balance(n->kv, eraseFrom(n->left, key), retain(n->right));
+        if (less(n->kv.first, key)) return balance(n->kv, retain(n->left), eraseFrom(n->right, key));
+        if (!n->left) return retain(n->right);
+        if (!n->right) return retain(n->left);
+        const Node* min = nullptr;
+        const Node* r = eraseMin(n->right, min);
+        return balance(min->kv, retain(n->left), r);
+    }
+
+    const Node* findNode(const Key &key) const {
+        const Node* n = root;
+        while (n) {
+            bool goLeft = less(key, n->kv.first);
+            bool goRight = less(n->kv.first, key);
+            if (goLeft == goRight) return n;
+            n = goRight ? n->right : n->left;
+        }
+        return nullptr;
+    }
+
+    template <class It>
+    static const Node* buildSorted(size_t n, It &next) {
+        if (n == 0) return nullptr;
+        size_t leftCount = (n - 1) / 2;
+        const Node* left = buildSorted(leftCount, next);
+        value_type kv(next->first, next->second);
+        ++next;
+        const Node* right = buildSorted(n - 1 - leftCount, next);
+        return new Node(kv, left, right);
+    }
+
+    void replaceRoot(const Node* n) {
+        release(root);
+        root = n;
+    }
+
+public:
+    PersistentAVLMap() = default;
+    explicit PersistentAVLMap(const Compare &comp) : less(comp) {}
+
+    // O(1) snapshot: shares every node
+    PersistentAVLMap(const PersistentAVLMap &other) : root(retain(other.root)), count(other.count), less(other.less) {}
+    PersistentAVLMap &operator=(const PersistentAVLMap &other) {
+        if (this != &other) {
+            replaceRoot(retain(other.root));
+            count = other.count;
+            less = other.less;
+        }
+        return *this;
+    }
+
+    PersistentAVLMap(PersistentAVLMap &&other) noexcept
+        : root(other.root), count(other.count), less(std::move(other.less)) {
+        other.root = nullptr;
+        other.count = 0;
+    }
+    PersistentAVLMap &operator=(PersistentAVLMap &&other) noexcept {
+        if (this != &other) {
+            replaceRoot(other.root);
+            count = other.count;
+            less = std::move(other.less);
+            other.root = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    ~PersistentAVLMap() { release(root); }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int height() const { return getHeight(root); }
+    void clear() {
+        replaceRoot(nullptr);
+        count = 0;
+    }
+
+    // Nodes alive across every version of every map of this type
+    static size_t liveNodes() { return live.load(std::memory_order_relaxed); }
+    static constexpr size_t nodeBytes() { return sizeof(Node); }
+
+    // Value stored under key, or nullptr
+    const Value* find(const Key &key) const {
+        const Node* n = findNode(key);
+        return n ? &n->kv.second : nullptr;
+    }
+
+    bool contains(const Key &key) const { return findNode(key) != nullptr; }
+
+    // Visits every element in key order
+    template <class F>
+    void forEach(F visit) const {
+        inorderIterative(root, [&](const Node* n) { visit(n->kv); });
+    }
+
+    // Inserts (key, value) unless key is present; never overwrites
+    bool insert(const Key &key, const Value &value) {
+        bool inserted = false;
+        const Node* n = insertInto<false>(root, key, value, inserted);
+        if (!n) return false;
+        replaceRoot(n);
+        count++;
+        return true;
+    }
+
+    // Inserts or overwrites; returns whether key was new
+    bool insert_or_assign(const Key &key, const Value &value) {
+        bool inserted = false;
+        replaceRoot(insertInto<true>(root, key, value, inserted));
+        if (inserted) count++;
+        return inserted;
+    }
+
+    size_t erase(const Key &key) {
+        if (!findNode(key)) return 0;
+        replaceRoot(eraseFrom(root, key));
+        count--;
+        return 1;
+    }
+
+    // Replaces the contents with [first, last) in O(n). The range must hold
+    // (key, value) pairs sorted by key with no duplicates.
+    template <class It>
+    void assignSorted(It first, It last) {
+        size_t n = size_t(std::distance(first, last));
+        replaceRoot(buildSorted(n, first));
+        count = n;
+    }
+};
+
+#endif
@@ -4,137 +4,45 @@
 #include <iomanip>
 #include <algorithm>
 #include <sstream>
+#include <limits>
+#include "financetracker.h"
 using namespace std;
 
-struct Transaction {
-    string date;       // format: YYYY-MM-DD
-    string type;       // Income / Expense
-    string description;
-    float amount;
-};
-
-class FinanceTracker {
-private:
-    vector<Transaction> transactions;
-
-public:
-    void addTransaction() {
-        Transaction t;
-        cout << "Enter date (YYYY-MM-DD): ";
-        cin >> t.date;
-        cout << "Enter type (Income/Expense): ";
-        cin >> t.type;
-        cin.ignore();
-        cout << "Enter description: ";
-        getline(cin, t.description);
-        cout << "Enter amount: ";
-        cin >> t.amount;
-
-        transactions.push_back(t);
-        cout << "Transaction added successfully!\n";
-    }
-
-    void viewTransactions() {
-        if (transactions.empty()) {
-            cout << "No transactions found.\n";
-            return;
-        }
-
-        cout << "\n--- All Transactions ---\n";
-        for (size_t i = 0; i < transactions.size(); i++) {
-            cout << i + 1 << ". Date: " << transactions[i].date
-                 << " | Type: " << transactions[i].type
-                 << " | Amount: " << fixed << setprecision(2) << transactions[i].amount
-                 << " | Description: " << transactions[i].description << "\n";
-        }
-    }
-
-    void searchTransactions() {
-        float limit;
-        cout << "Enter amount limit to search (e.g., 100): ";
-        cin >> limit;
-
-        cout << "\n--- Transactions above " << limit << " ---\n";
-        for (auto &t : transactions) {
-            if (t.amount > limit) {
-                cout << "Date: " << t.date
-                     << " | Type: " << t.type
-                     << " | Amount: " << t.amount
-                     << " | Desc: " << t.description << "\n";
-            }
-        }
-    }
-
-    void sortTransactions() {
-        sort(transactions.begin(), transactions.end(),
-             [](Transaction &a, Transaction &b) {
-                 return a.amount < b.amount;
-             });
-        cout << "Transactions sorted by amount!\n";
-    }
-
-    void saveToFile() {
-        ofstream fout("finance.dat");
-        if (!fout) {
-            cout << "Error saving file!\n";
-            return;
-        }
-        for (auto &t : transactions) {
-            fout << t.date << "|" << t.type << "|" << t.amount << "|" << t.description << "\n";
-        }
-        fout.close();
-        cout << "Data saved successfully!\n";
-    }
-
-    void loadFromFile() {
-        ifstream fin("finance.dat");
-        if (!fin) {
-            cout << "No saved data found!\n";
-            return;
-        }
-        transactions.clear();
-        string line;
-        while (getline(fin, line)) {
-            stringstream ss(line);
-            Transaction t;
-            string amt;
-            getline(ss, t.date, '|');
-            getline(ss, t.type, '|');
-            getline(ss, amt, '|');
-            getline(ss, t.description, '|');
-            t.amount = stof(amt);
-            transactions.push_back(t);
-        }
-        fin.close();
-        cout << "Data loaded successfully!\n";
-    }
-
-    void monthlyReport() {
-        float monthSum[13] = {0};
-
-        for (auto &t : transactions) {
-            int month;
-            sscanf(t.date.c_str(), "%*d-%d-%*d", &month);
-            monthSum[month] += t.amount;
-        }
-
-        cout << "\n--- Monthly Spending Report ---\n";
-        for (int m = 1; m <= 12; m++) {
-            if (monthSum[m] > 0) {
-                cout << "Month " << setw(2) << m << " : ";
-                int stars = (int)(monthSum[m] / 100); // 1 star = 100 units
-                for (int k = 0; k < stars; k++) cout << "*";
-                cout << " (" << fixed << setprecision(2) << monthSum[m] << ")\n";
-            }
-        }
+// --check: monthlyReport on rows with good and malformed dates. A month
+// outside 1..12, or no month at all, used to index outside monthSum.
+int checkReport() {
+    const pair<const char*, float> rows[] = {
+        {"2024-03-05", 250}, {"2024-03-20", 50}, {"2024-11-02", 120},
+        {"2024-13-01", 999}, {"2024-00-10", 999}, {"not a date", 999},
+    };
+    FinanceTracker tracker;
+    for (auto &r : rows) tracker.addTransaction({r.first, "Expense", "check", r.second});
+
+    const string expected = "\n--- Monthly Spending Report ---\n"
+                            "Month  3 : *** (300.00)\n"
+                            "Month 11 : * (120.00)\n"
+                            "Skipped 3 transaction(s) without a valid YYYY-MM-DD date.\n";
+    ostringstream out;
+    streambuf* saved = cout.rdbuf(out.rdbuf());
+    tracker.monthlyReport();
+    cout.rdbuf(saved);
+    if (out.str() != expected) {
+        cout << "FAIL: monthlyReport printed" << out.str() << "expected" << expected;
+        return 1;
     }
-};
+    cout << "OK: monthlyReport skipped the 3 malformed dates\n";
+    return 0;
+}
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--check") return checkReport();
+    // --metrics file: write a Prometheus snapshot there on exit
+    string metricsPath = argc > 2 && string(argv[1]) == "--metrics" ? argv[2] : "";
     FinanceTracker tracker;
     int choice;
+    bool running = true;
 
-    while (true) {
+    while (running) {
         cout << "\n===== Personal Finance Tracker =====\n";
         cout << "1. Add Transaction\n";
         cout << "2. View All Transactions\n";
@@ -143,9 +51,16 @@ int main() {
         cout << "5. Save to File\n";
         cout << "6. Load from File\n";
         cout << "7. Monthly Report\n";
-        cout << "8. Exit\n";
+        cout << "8. Show statistics\n";
+        cout << "9. Exit\n";
         cout << "Enter choice: ";
-        cin >> choice;
+        if (!(cin >> choice)) {
+            if (cin.eof()) break;   // end of input exits like choice 9
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            cout << "Invalid choice!\n";
+            continue;
+        }
 
         switch (choice) {
             case 1: tracker.addTransaction(); break;
@@ -155,9 +70,18 @@ int main() {
             case 5: tracker.saveToFile(); break;
             case 6: tracker.loadFromFile(); break;
             case 7: tracker.monthlyReport(); break;
-            case 8: exit(0);
+            case 8:
+                dumpStats(cout);
+                writePrometheus(cout);
+                break;
+            case 9: running = false; break;
             default: cout << "Invalid choice!\n";
         }
     }
+
+    if (!metricsPath.empty() && !writePrometheusFile(metricsPath)) {
+        cout << "Cannot write " << metricsPath << "\n";
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,394 @@
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include <iostream>
+#include <string>
+#include "stats.h"
+
+// Compiled in only with -DHOTPATH_STATS, see stats.h
+STATS_HISTOGRAM(routeFindNodes, "route_find_nodes_visited", "Stations compared per findStationPtr call")
+STATS_HISTOGRAM(routeFindLatency, "route_find_latency_ns", "findStationPtr latency in nanoseconds")
+STATS_COUNTER(routeFindMisses, "route_find_misses", "findStationPtr calls that found no station")
+STATS_HISTOGRAM(routeTravelNodes, "route_travel_nodes_visited",
+                "Stations walked per travelBetween call, not counting the two lookups")
+STATS_HISTOGRAM(routeTravelLatency, "route_travel_latency_ns", "travelBetween latency in nanoseconds, with output")
+STATS_COUNTER(routeTravelUnknown, "route_travel_unknown_station", "travelBetween calls naming a missing station")
+
+struct Station {
+    std::string name;
+    Station* prev;
+    Station* next;
+    Station(const std::string &n) : name(n), prev(nullptr), next(nullptr) {}
+};
+
+class Route {
+private:
+    Station* head;
+    Station* tail;
+    Station* current;     // pointer to simulate train position
+    bool isCircular;
+
+public:
+    Route() : head(nullptr), tail(nullptr), current(nullptr), isCircular(false) {}
+
+    ~Route() {
+        clear();
+    }
+
+    void clear() {
+        if (!head) return;
+        // If circular, break circle first
+        if (isCircular && tail) {
+            tail->next = nullptr;
+            head->prev = nullptr;
+        }
+        Station* ptr = head;
+        while (ptr) {
+            Station* nxt = ptr->next;
+            delete ptr;
+            ptr = nxt;
+        }
+        head = tail = current = nullptr;
+    }
+
+    bool empty() const {
+        return head == nullptr;
+    }
+
+    void setCircular(bool c) {
+        isCircular = c;
+        if (!head) return;
+        if (isCircular) {
+            head->prev = tail;
+            tail->next = head;
+        } else {
+            // break the links
+            head->prev = nullptr;
+            tail->next = nullptr;
+        }
+    }
+
+    void addStationEnd(const std::string &name) {
+        Station* node = new Station(name);
+        if (!head) {
+            head = tail = node;
+            if (isCircular) {
+                head->next = head->prev = head;
+            }
+        } else {
+            if (isCircular) {
+                // tail -> node -> head, maintain circular links
+                node->prev = tail;
+                node->next = head;
+                tail->next = node;
+                head->prev = node;
+                tail = node;
+            } else {
+                node->prev = tail;
+                tail->next = node;
+                tail = node;
+            }
+        }
+        if (!current) current = head; // set current if first station added
+    }
+
+    void addStationBeginning(const std::string &name) {
+        Station* node = new Station(name);
+        if (!head) {
+            head = tail = node;
+            if (isCircular) {
+                head->next = head->prev = head;
+            }
+        } else {
+            if (isCircular) {
+                node->next = head;
+                node->prev = tail;
+                head->prev = node;
+                tail->next = node;
+                head = node;
+            } else {
+                node->next = head;
+                head->prev = node;
+                head = node;
+            }
+        }
+        if (!current) current = head;
+    }
+
+    bool insertAfter(const std::string &afterName, const std::string &name) {
+        Station* p = findStationPtr(afterName);
+        if (!p) return false;
+        Station* node = new Station(name);
+        if (isCircular && p == tail) {
+            // inserting after tail: new tail
+            node->prev = tail;
+            node->next = head;
+            tail->next = node;
+            head->prev = node;
+            tail = node;
+        } else if (!isCircular && p == tail) {
+            // normal tail insertion
+            node->prev = tail;
+            tail->next = node;
+            tail = node;
+        } else {
+            // middle insertion
+            Station* nxt = p->next;
+            node->next = nxt;
+            node->prev = p;
+            p->next = node;
+            if (nxt) nxt->prev = node;
+        }
+        return true;
+    }
+
+    bool removeStation(const std::string &name) {
+        Station* p = findStationPtr(name);
+        if (!p) return false;
+
+        if (p == head && p == tail) {
+            // only one node
+            delete p;
+            head = tail = current = nullptr;
+            return true;
+        }
+
+        if (isCircular) {
+            // update neighbors
+            p->prev->next = p->next;
+            p->next->prev = p->prev;
+            if (p == head) head = p->next;
+            if (p == tail) tail = p->prev;
+        } else {
+            if (p->prev) p->prev->next = p->next;
+            if (p->next) p->next->prev = p->prev;
+            if (p == head) head = p->next;
+            if (p == tail) tail = p->prev;
+        }
+
+        // move current if it pointed to deleted node
+        if (current == p) {
+            current = p->next ? p->next : head;
+        }
+
+        delete p;
+        return true;
+    }
+
+    Station* findStationPtr(const std::string &name) const {
+        STATS_TIME_SCOPE(routeFindLatency);
+        StatTally visited;
+        Station* found = nullptr;
+        Station* ptr = head;
+        if (isCircular && head) {
+            do {
+                visited.add();
+                if (ptr->name == name) {
+                    found = ptr;
+                    break;
+                }
+                ptr = ptr->next;
+            } while (ptr != head);
+        } else {
+            while (ptr) {
+                visited.add();
+                if (ptr->name == name) {
+                    found = ptr;
+                    break;
+                }
+                ptr = ptr->next;
+            }
+        }
+        STATS_OBSERVE(routeFindNodes, visited.n);
+        if (!found) STATS_ADD(routeFindMisses, 1);
+        return found;
+    }
+
+    bool findStation(const std::string &name) const {
+        return findStationPtr(name) != nullptr;
+    }
+
+    void displayForward() const {
+        if (!head) {
+            std::cout << "[Empty route]\n";
+            return;
+        }
+        std::cout << "Route (forward): ";
+        Station* ptr = head;
+        if (isCircular) {
+            bool first = true;
+            do {
+                std::cout << (first ? "" : " -> ") << ptr->name;
+                first = false;
+                ptr = ptr->next;
+            } while (ptr != head);
+        } else {
+            while (ptr) {
+                std::cout << ptr->name;
+                if (ptr->next) std::cout << " -> ";
+                ptr = ptr->next;
+            }
+        }
+        std::cout << "\n";
+    }
+
+    void displayBackward() const {
+        if (!tail) {
+            std::cout << "[Empty route]\n";
+            return;
+        }
+        std::cout << "Route (backward): ";
+        Station* ptr = tail;
+        if (isCircular) {
+            bool first = true;
+            do {
+                std::cout << (first ? "" : " -> ") << ptr->name;
+                first = false;
+                ptr = ptr->prev;
+            } while (ptr != tail);
+        } else {
+            while (ptr) {
+                std::cout << ptr->name;
+                if (ptr->prev) std::cout << " -> ";
+                ptr = ptr->prev;
+            }
+        }
+        std::cout << "\n";
+    }
+
+    void setCurrentAt(const std::string &name) {
+        Station* p = findStationPtr(name);
+        if (!p) {
+            std::cout << "Station '" << name << "' not found.\n";
+            return;
+        }
+        current = p;
+        std::cout << "Current position set to '" << current->name << "'.\n";
+    }
+
+    void resetCurrentToHead() {
+        current = head;
+        if (current) std::cout << "Current position set to head: " << current->name << "\n";
+        else std::cout << "Route is empty.\n";
+    }
+
+    void moveNext(int steps = 1) {
+        if (!current) {
+            std::cout << "No current station set.\n";
+            return;
+        }
+        for (int i = 0; i < steps; ++i) {
+            if (current->next) current = current->next;
+            else {
+                std::cout << "Reached end of linear route, cannot move next further.\n";
+                return;
+            }
+        }
+        std::cout << "Now at: " << current->name << "\n";
+    }
+
+    void movePrev(int steps = 1) {
+        if (!current) {
+            std::cout << "No current station set.\n";
+            return;
+        }
+        for (int i = 0; i < steps; ++i) {
+            if (current->prev) current = current->prev;
+            else {
+                std::cout << "Reached start of linear route, cannot move previous further.\n";
+                return;
+            }
+        }
+        std::cout << "Now at: " << current->name << "\n";
+    }
+
+    void showCurrent() const {
+        if (!current) std::cout << "No current station set.\n";
+        else std::cout << "Current station: " << current->name << "\n";
+    }
+
+    void displayDetailed() const {
+        std::cout << "Route details:\n";
+        std::cout << (isCircular ? "Type: Circular\n" : "Type: Linear\n");
+        displayForward();
+        displayBackward();
+        if (current) std::cout << "Current station: " << current->name << "\n";
+    }
+
+    // Utility to create a sample route quickly
+    void createSampleRoute() {
+        clear();
+        addStationEnd("StationA");
+        addStationEnd("StationB");
+        addStationEnd("StationC");
+        addStationEnd("StationD");
+        addStationEnd("StationE");
+        resetCurrentToHead();
+        std::cout << "Sample route created (A->B->C->D->E).\n";
+    }
+
+    // Simulate travel between two named stations (linear calculation)
+    void travelBetween(const std::string &from, const std::string &to) {
+        STATS_TIME_SCOPE(routeTravelLatency);
+        Station* f = findStationPtr(from);
+        Station* t = findStationPtr(to);
+        if (!f || !t) {
+            STATS_ADD(routeTravelUnknown, 1);
+            std::cout << "One or both stations not found.\n";
+            return;
+        }
+        // If circular route, we can decide shortest path in steps (both directions)
+        if (isCircular) {
+            // measure steps forward
+            int forwardSteps = 0;
+            Station* p = f;
+            while (p->name != t->name) {
+                p = p->next; forwardSteps++;
+                if (p == f) break; // safety
+            }
+            // measure steps backward
+            int backwardSteps = 0;
+            p = f;
+            while (p->name != t->name) {
+                p = p->prev; backwardSteps++;
+                if (p == f) break;
+            }
+            STATS_OBSERVE(routeTravelNodes, uint64_t(forwardSteps + backwardSteps));
+            std::cout << "Travel from " << from << " to " << to << " (circular): choose ";
+            if (forwardSteps <= backwardSteps) {
+                std::cout << "forward (" << forwardSteps << " stops).\n";
+            } else {
+                std::cout << "backward (" << backwardSteps << " stops).\n";
+            }
+        } else {
+            // linear: find direction if possible
+            // try forward
+            int forwardSteps = 0;
+            Station* p = f;
+            while (p && p->name != t->name) {
+                p = p->next; forwardSteps++;
+            }
+            bool ahead = p != nullptr;
+            // try backward
+            int backwardSteps = 0;
+            p = f;
+            while (p && p->name != t->name) {
+                p = p->prev; backwardSteps++;
+            }
+            bool behind = p != nullptr;
+            STATS_OBSERVE(routeTravelNodes, uint64_t(forwardSteps + backwardSteps));
+            if (!ahead && !behind) {
+                std::cout << "No path from " << from << " to " << to << " in linear route.\n";
+            } else {
+                // the walk that ran off the end counted steps to nowhere
+                if (ahead && (!behind || forwardSteps < backwardSteps)) {
+                    std::cout << "Travel forward " << forwardSteps << " stops from " << from << " to " << to << ".\n";
+                } else {
+                    std::cout << "Travel backward " << backwardSteps << " stops from " << from << " to " << to << ".\n";
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Optional hot-path instrumentation: counters and histograms that are
+// compiled in only with -DHOTPATH_STATS. Without it the STATS_* macros
+// expand to nothing and StatTally is an empty type, so an uninstrumented
+// build runs exactly the code it ran before.
+//
+// With it, every update is one relaxed atomic add per metric, plus two
+// steady_clock reads per timed call. Histograms use power-of-two buckets:
+// bucket i holds values in (2^(i-1), 2^i]. Metrics register themselves
+// on construction and can be read as a human-readable dump or as a
+// Prometheus text-format snapshot, written to any stream or local file.
+
+class StatMetric;
+
+class StatsRegistry {
+private:
+    std::mutex lock;
+    std::vector<const StatMetric*> metrics;
+
+public:
+    static StatsRegistry &instance() {
+        static StatsRegistry r;
+        return r;
+    }
+
+    void add(const StatMetric* m) {
+        std::lock_guard<std::mutex> guard(lock);
+        metrics.push_back(m);
+    }
+
+    std::vector<const StatMetric*> all() {
+        std::lock_guard<std::mutex> guard(lock);
+        return metrics;
+    }
+};
+
+class StatMetric {
+public:
+    const char* name;
+    const char* help;
+
+    StatMetric(const char* n, const char* h) : name(n), help(h) { StatsRegistry::instance().add(this); }
+    StatMetric(const StatMetric &) = delete;
+    StatMetric &operator=(const StatMetric &) = delete;
+    virtual ~StatMetric() = default;
+
+    virtual void dump(std::ostream &os) const = 0;
+    virtual void prometheus(std::ostream &os) const = 0;
+};
+
+class StatCounter : public StatMetric {
+private:
+    std::atomic<uint64_t> total{0};
+
+public:
+    using StatMetric::StatMetric;
+
+    void add(uint64_t n = 1) { total.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return total.load(std::memory_order_relaxed); }
+
+    void dump(std::ostream &os) const override {
+        os << std::left << std::setw(36) << name << std::right << " total " << value() << "\n";
+    }
+
+    void prometheus(std::ostream &os) const override {
+        os << "# HELP " << name << "_total " << help << "\n# TYPE " << name << "_total counter\n"
+           << name << "_total " << value() << "\n";
+    }
+};
+
+class StatHistogram : public StatMetric {
+public:
+    static constexpr int Buckets = 41;   // up to 2^40; larger values land in +Inf
+
+private:
+    std::atomic<uint64_t> buckets[Buckets + 1] = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+
+    static int bucketOf(uint64_t v) {
+        if (v <= 1) return 0;
+        int b = 64 - __builtin_clzll(v - 1);
+        return b < Buckets ? b : Buckets;
+    }
+
+    // Upper bound of the bucket holding the q-th quantile
+    uint64_t quantile(double q) const {
+        uint64_t n = count.load(std::memory_order_relaxed);
+        uint64_t target = uint64_t(q * double(n) + 0.5), seen = 0;
+        for (int b = 0; b < Buckets; b++) {
+            seen += buckets[b].load(std::memory_order_relaxed);
+            if (seen >= target && seen > 0) return uint64_t(1) << b;
+        }
+        return uint64_t(1) << Buckets;
+    }
+
+public:
+    using StatMetric::StatMetric;
+
+    void observe(uint64_t v) {
+        buckets[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(v, std::memory_order_relaxed);
+    }
+
+    void dump(std::ostream &os) const override {
+        uint64_t n = count.load(std::memory_order_relaxed), s = sum.load(std::memory_order_relaxed);
+        os << std::left << std::setw(36) << name << std::right << " count " << n << "  mean " << std::fixed
+           << std::setprecision(1) << (n ? double(s) / double(n) : 0.0);
+        if (n) os << "  p50 <= " << quantile(0.5) << "  p99 <= " << quantile(0.99);
+        os << "\n";
+    }
+
+    void prometheus(std::ostream &os) const override {
+        os << "# HELP " << name << " " << help << "\n# TYPE " << name << " histogram\n";
+        uint64_t cumulative = 0;
+        int last = 0;   // skip the empty buckets above the largest value
+        for (int b = 0; b <= Buckets; b++) {
+            if (buckets[b].load(std::memory_order_relaxed)) last = b;
+        }
+        for (int b = 0; b <= last && b < Buckets; b++) {
+            cumulative += buckets[b].load(std::memory_order_relaxed);
+            os << name << "_bucket{le=\"" << (uint64_t(1) << b) << "\"} " << cumulative << "\n";
+        }
+        os << name << "_bucket{le=\"+Inf\"} " << count.load(std::memory_order_relaxed) << "\n"
+           << name << "_sum " << sum.load(std::memory_order_relaxed) << "\n"
+           << name << "_count " << count.load(std::memory_order_relaxed) << "\n";
+    }
+};
+
+// Records the lifetime of the enclosing scope, in nanoseconds
+class ScopedLatency {
+private:
+    StatHistogram &hist;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    explicit ScopedLatency(StatHistogram &h) : hist(h) {}
+    ScopedLatency(const ScopedLatency &) = delete;
+    ScopedLatency &operator=(const ScopedLatency &) = delete;
+    ~ScopedLatency() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        hist.observe(uint64_t(ns.count()));
+    }
+};
+
+#if defined(HOTPATH_STATS)
+
+constexpr bool StatsEnabled = true;
+
+// Local per-call tally, e.g. of nodes visited, reported once at the end
+struct StatTally {
+    uint64_t n = 0;
+    void add(uint64_t k = 1) { n += k; }
+};
+
+#define STATS_COUNTER(var, name, help) inline StatCounter var{name, help};
+#define STATS_HISTOGRAM(var, name, help) inline StatHistogram var{name, help};
+#define STATS_ADD(counter, n) (counter).add(n)
+#define STATS_OBSERVE(hist, value) (hist).observe(value)
+#define STATS_CONCAT2(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT2(a, b)
+#define STATS_TIME_SCOPE(hist) ScopedLatency STATS_CONCAT(statsLatency, __LINE__)(hist)
+
+#else
+
+constexpr bool StatsEnabled = false;
+
+struct StatTally {
+    void add(uint64_t = 1) {}
+};
+
+#define STATS_COUNTER(var, name, help)
+#define STATS_HISTOGRAM(var, name, help)
+#define STATS_ADD(counter, n) ((void)0)
+#define STATS_OBSERVE(hist, value) ((void)0)
+#define STATS_TIME_SCOPE(hist) ((void)0)
+
+#endif
+
+// Readable summary of every registered metric
+inline void dumpStats(std::ostream &os) {
+    if (!StatsEnabled) {
+        os << "Statistics are compiled out; rebuild with -DHOTPATH_STATS.\n";
+        return;
+    }
+    for (const StatMetric* m : StatsRegistry::instance().all()) m->dump(os);
+}
+
+// Prometheus text exposition format, for a scrape endpoint or a
+// node_exporter textfile
+inline void writePrometheus(std::ostream &os) {
+    for (const StatMetric* m : StatsRegistry::instance().all()) m->prometheus(os);
+}
+
+inline bool writePrometheusFile(const std::string &path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    writePrometheus(out);
+    return bool(out);
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef TRAVERSAL_H
+#define TRAVERSAL_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Depth-first traversals without recursion for any node type with left
+// and right child pointers. The visitor is called once per node, so the
+// same walk can print, sum or copy keys.
+//
+// The explicit-stack walks keep their stack on the heap, sized by the
+// tree height, so a degenerate tree with millions of levels cannot
+// overflow the call stack. The Morris walks need no stack at all: they
+// temporarily point the rightmost node of each left subtree back at its
+// ancestor and undo it on the way out. While one runs, right pointers
+// may be threads, so its visitor should read only the node's payload,
+// and nothing else may use the tree.
+
+template <class NodePtr, class Visit>
+void inorderIterative(NodePtr root, Visit visit) {
+    std::vector<NodePtr> st;
+    NodePtr cur = root;
+    while (cur || !st.empty()) {
+        while (cur) {
+            st.push_back(cur);
+            cur = cur->left;
+        }
+        cur = st.back();
+        st.pop_back();
+        visit(cur);
+        cur = cur->right;
+    }
+}
+
+template <class NodePtr, class Visit>
+void preorderIterative(NodePtr root, Visit visit) {
+    std::vector<NodePtr> st;
+    if (root) st.push_back(root);
+    while (!st.empty()) {
+        NodePtr n = st.back();
+        st.pop_back();
+        visit(n);
+        if (n->right) st.push_back(n->right);
+        if (n->left) st.push_back(n->left);
+    }
+}
+
+// One stack: a node is emitted once its right subtree is done, which is
+// when that subtree's root was the last node visited
+template <class NodePtr, class Visit>
+void postorderIterative(NodePtr root, Visit visit) {
+    std::vector<NodePtr> st;
+    NodePtr cur = root;
+    NodePtr last = nullptr;
+    while (cur || !st.empty()) {
+        if (cur) {
+            st.push_back(cur);
+            cur = cur->left;
+        } else {
+            NodePtr top = st.back();
+            if (top->right && top->right != last) {
+                cur = top->right;
+            } else {
+                visit(top);
+                last = top;
+                st.pop_back();
+            }
+        }
+    }
+}
+
+template <class NodePtr, class Visit>
+void morrisInorder(NodePtr root, Visit visit) {
+    NodePtr cur = root;
+    while (cur) {
+        if (!cur->left) {
+            visit(cur);
+            cur = cur->right;
+            continue;
+        }
+        NodePtr pred = cur->left;
+        while (pred->right && pred->right != cur) pred = pred->right;
+        if (!pred->right) {
+            pred->right = cur;   // thread back, then descend
+            cur = cur->left;
+        } else {
+            pred->right = nullptr;   // left subtree done: unthread
+            visit(cur);
+            cur = cur->right;
+        }
+    }
+}
+
+template <class NodePtr, class Visit>
+void morrisPreorder(NodePtr root, Visit visit) {
+    NodePtr cur = root;
+    while (cur) {
+        if (!cur->left) {
+            visit(cur);
+            cur = cur->right;
+            continue;
+        }
+        NodePtr pred = cur->left;
+        while (pred->right && pred->right != cur) pred = pred->right;
+        if (!pred->right) {
+            visit(cur);
+            pred->right = cur;
+            cur = cur->left;
+        } else {
+            pred->right = nullptr;
+            cur = cur->right;
+        }
+    }
+}
+
+// ---------------- Fork-join ----------------
+// The top of the tree is split between threads: each fork hands the left
+// subtree to a new thread and keeps the right one, until the thread
+// budget is spent; below that every subtree is walked sequentially. Only
+// log2(threads) levels ever fork, so the split is even on balanced trees
+// and merely sequential on degenerate ones.
+
+template <class NodePtr, class T, class Map, class Combine>
+T forkReduce(NodePtr n, const T &identity, Map &map, Combine &combine, unsigned threads) {
+    if (!n) return identity;
+    if (threads <= 1) {
+        T acc = identity;
+        inorderIterative(n, [&](NodePtr x) { acc = combine(acc, map(x)); });
+        return acc;
+    }
+    T left = identity;
+    std::thread worker([&] { left = forkReduce(n->left, identity, map, combine, threads / 2); });
+    T right = forkReduce(n->right, identity, map, combine, threads - threads / 2);
+    worker.join();
+    return combine(combine(left, map(n)), right);
+}
+
+// Folds map(node) over the tree with combine, in parallel. When combine is
+// associative the result equals the sequential inorder fold. map and
+// combine are called from several threads at once.
+template <class NodePtr, class T, class Map, class Combine>
+T parallelReduce(NodePtr root, T identity, Map map, Combine combine,
+                 unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+    return forkReduce(root, identity, map, combine, std::max(threads, 1u));
+}
+
+// Visits every node exactly once, in no particular order; visit must be
+// safe to call from several threads at once
+template <class NodePtr, class Visit>
+void parallelForEach(NodePtr root, Visit visit,
+                     unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+    parallelReduce(root, 0, [&](NodePtr n) { visit(n); return 0; }, [](int, int) { return 0; }, threads);
+}
+
+#endif
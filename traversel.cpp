@@ -1,4 +1,13 @@
 #include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
+#include "traversal.h"
 using namespace std;
 struct Node{
     int data;
@@ -12,29 +21,108 @@ struct Node{
     }
 };
 void inorder(Node*root){
-    if(root){
-        inorder(root->left);
-        cout<<root->data<<" ";
-        inorder(root->right);
-    }
-    
+    inorderIterative(root,[](Node*n){cout<<n->data<<" ";});
 }
 void preorder(Node*root){
-    if(root){
-        cout<<root->data<<" ";
-        preorder(root->left);
-        preorder(root->right);
-    }
+    preorderIterative(root,[](Node*n){cout<<n->data<<" ";});
 }
 void postorder(Node*root){
+    postorderIterative(root,[](Node*n){cout<<n->data<<" ";});
+}
+
+template <class F> double secondsFor(F body){
+    auto start=chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now()-start).count();
+}
+
+// The old recursive walk, kept only as the benchmark baseline
+void sumRecursive(Node*root,long long &sum){
     if(root){
-        postorder(root->left);
-        postorder(root->right);
-        cout<<root->data<<" ";
+        sumRecursive(root->left,sum);
+        sum+=root->data;
+        sumRecursive(root->right,sum);
     }
 }
 
-int main() {
+// Balanced tree over nodes[lo, hi) with keys lo..hi-1, stored in the
+// pool in random order so the walks pay for real pointer chasing
+Node* buildBalanced(vector<Node>&pool,const vector<size_t>&slot,size_t lo,size_t hi){
+    if(lo>=hi) return nullptr;
+    size_t mid=lo+(hi-lo)/2;
+    Node*n=&pool[slot[mid]];
+    n->data=int(mid);
+    n->left=buildBalanced(pool,slot,lo,mid);
+    n->right=buildBalanced(pool,slot,mid+1,hi);
+    return n;
+}
+
+// Sums the keys of an n-node tree with every traversal. A degenerate
+// chain of the same size is then walked iteratively: the recursive
+// version would need n stack frames.
+void benchmarkTraversals(size_t n){
+    vector<Node> pool(n,Node(0));
+    vector<size_t> slot(n);
+    for(size_t i=0;i<n;i++) slot[i]=i;
+    shuffle(slot.begin(),slot.end(),mt19937(42));
+    Node*root=buildBalanced(pool,slot,0,n);
+    slot=vector<size_t>();
+
+    long long expected=(long long)n*(long long)(n-1)/2;
+    unsigned threads=max(1u,thread::hardware_concurrency());
+    cout<<"Summing "<<n<<" keys of a balanced tree (expected "<<expected<<")\n";
+    cout<<fixed<<setprecision(2);
+    auto row=[&](const char*name,double secs,long long sum){
+        cout<<"  "<<left<<setw(22)<<name<<right<<setw(8)<<secs<<" s"<<setw(8)<<secs*1e9/n<<" ns/node"
+            <<(sum==expected?"":"  WRONG SUM")<<"\n";
+    };
+    long long sum=0;
+    double t=secondsFor([&]{ sumRecursive(root,sum); });
+    row("recursive",t,sum);
+    sum=0;
+    t=secondsFor([&]{ inorderIterative(root,[&](Node*x){sum+=x->data;}); });
+    row("inorder, stack",t,sum);
+    sum=0;
+    t=secondsFor([&]{ preorderIterative(root,[&](Node*x){sum+=x->data;}); });
+    row("preorder, stack",t,sum);
+    sum=0;
+    t=secondsFor([&]{ postorderIterative(root,[&](Node*x){sum+=x->data;}); });
+    row("postorder, stack",t,sum);
+    sum=0;
+    t=secondsFor([&]{ morrisInorder(root,[&](Node*x){sum+=x->data;}); });
+    row("inorder, Morris",t,sum);
+    sum=0;
+    t=secondsFor([&]{ morrisPreorder(root,[&](Node*x){sum+=x->data;}); });
+    row("preorder, Morris",t,sum);
+    t=secondsFor([&]{
+        sum=parallelReduce(root,0LL,[](Node*x){return (long long)x->data;},
+                           [](long long a,long long b){return a+b;},threads);
+    });
+    string label="fork-join, "+to_string(threads)+" thr";
+    row(label.c_str(),t,sum);
+
+    // reuse the pool as a chain of right children
+    for(size_t i=0;i<n;i++){
+        pool[i].data=int(i);
+        pool[i].left=nullptr;
+        pool[i].right=i+1<n?&pool[i+1]:nullptr;
+    }
+    cout<<"Degenerate chain of "<<n<<" nodes\n";
+    sum=0;
+    t=secondsFor([&]{ inorderIterative(&pool[0],[&](Node*x){sum+=x->data;}); });
+    row("inorder, stack",t,sum);
+    sum=0;
+    t=secondsFor([&]{ morrisInorder(&pool[0],[&](Node*x){sum+=x->data;}); });
+    row("inorder, Morris",t,sum);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        size_t n = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100000000;
+        benchmarkTraversals(max(n, size_t(1)));
+        return 0;
+    }
+
     Node * root = new Node(10);
     root-> left=new Node(5);
     root-> right=new Node(9);
@@ -0,0 +1,235 @@
+#ifndef TREEFILE_H
+#define TREEFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Pointer-free on-disk form of an ordered set or map. The keys are
+// stored in Eytzinger order, i.e. as an implicit binary search tree in
+// BFS order: the root is at index 1 and the children of k are at 2k and
+// 2k + 1. The structure lives in the index arithmetic, so a file can be
+// memory-mapped and searched in place, with no deserialization pass.
+// Only the pages a query touches are read from disk. Values, if any,
+// are kept in a second array with the same order.
+//
+// The file is a 64-byte header, then the key array, then the value
+// array, each aligned to 64 bytes. Both arrays reserve an unused slot 0.
+// Keys and values must be trivially copyable, and files are only
+// portable between machines with the same byte order.
+
+struct NoValue {};
+
+struct TreeFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t keyBytes;
+    uint32_t valueBytes;
+    uint32_t reserved0;
+    uint64_t count;
+    uint64_t keysOffset;
+    uint64_t valuesOffset;
+    uint64_t fileBytes;
+    uint64_t reserved1;
+};
+
+static_assert(sizeof(TreeFileHeader) == 64, "TreeFileHeader must fill one cache line");
+
+constexpr char TreeFileMagic[8] = {'T', 'R', 'E', 'E', 'I', 'M', 'G', '\0'};
+constexpr uint32_t TreeFileVersion = 1;
+
+inline uint64_t alignTo64(uint64_t n) { return (n + 63) & ~uint64_t(63); }
+
+// Writes the elements of [first, last), which must be sorted and free of
+// duplicates, into slots k = 1..n in in-order order. Recursion depth is
+// only log2(n).
+template <class It, class Put>
+void fillEytzinger(It &first, size_t k, size_t n, Put &put) {
+    if (k > n) return;
+    fillEytzinger(first, 2 * k, n, put);
+    put(k, *first);
+    ++first;
+    fillEytzinger(first, 2 * k + 1, n, put);
+}
+
+// Saves a sorted range. For maps (Value other than NoValue) the range
+// holds (key, value) pairs, as AVLMap iterates them.
+template <class Key, class Value = NoValue, class It>
+bool writeTreeFile(const std::string &path, It first, It last) {
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                  "tree files store raw bytes");
+    static_assert(alignof(Key) <= 64 && alignof(Value) <= 64, "arrays are aligned to 64 bytes");
+    constexpr bool hasValues = !std::is_same<Value, NoValue>::value;
+    size_t n = size_t(std::distance(first, last));
+
+    TreeFileHeader h;
+    std::memset(&h, 0, sizeof h);
+    std::memcpy(h.magic, TreeFileMagic, sizeof h.magic);
+    h.version = TreeFileVersion;
+    h.keyBytes = sizeof(Key);
+    h.valueBytes = hasValues ? sizeof(Value) : 0;
+    h.count = n;
+    h.keysOffset = sizeof h;
+    h.valuesOffset = alignTo64(h.keysOffset + (n + 1) * sizeof(Key));
+    h.fileBytes = hasValues ? h.valuesOffset + (n + 1) * sizeof(Value) : h.keysOffset + (n + 1) * sizeof(Key);
+
+    std::vector<Key> keys(n + 1);
+    std::vector<Value> values(hasValues ? n + 1 : 0);
+    auto put = [&](size_t k, const auto &element) {
+        if constexpr (hasValues) {
+            keys[k] = element.first;
+            values[k] = element.second;
+        } else {
+            keys[k] = element;
+        }
+    };
+    fillEytzinger(first, 1, n, put);
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    static const char zeros[64] = {};
+    bool ok = fwrite(&h, sizeof h, 1, f) == 1 &&
+              fwrite(keys.data(), sizeof(Key), keys.size(), f) == keys.size();
+    if (ok && hasValues) {
+        size_t pad = size_t(h.valuesOffset - h.keysOffset - keys.size() * sizeof(Key));
+        ok = fwrite(zeros, 1, pad, f) == pad && fwrite(values.data(), sizeof(Value), values.size(), f) == values.size();
+    }
+    ok = fclose(f) == 0 && ok;
+    return ok;
+}
+
+// Read-only view of a tree file. open() maps the file and checks its
+// header; queries then run directly on the mapped pages.
+template <class Key, class Value = NoValue>
+class MappedTree {
+private:
+    void* base = nullptr;
+    size_t mappedBytes = 0;
+    const Key* keys = nullptr;      // keys[1..count]
+    const Value* values = nullptr;  // values[1..count], or nullptr for sets
+    size_t count = 0;
+
+    // Slot of the first key not less than x, or 0. The descent has no
+    // branches to mispredict, and prefetches the node four levels down
+    // (16 slots) while comparing this one.
+    size_t lowerBoundSlot(const Key &x) const {
+        size_t k = 1;
+        while (k <= count) {
+            __builtin_prefetch(keys + 16 * k);
+            k = 2 * k + (keys[k] < x);
+        }
+        // undo the right turns taken after the last left turn
+        k >>= __builtin_ffsll((long long)~k);
+        return k;
+    }
+
+    // Whether slots 0..count of an array at offset lie inside the file,
+    // checked so that no sum or product can wrap. The offset must also be
+    // on the 64-byte layout grid, which keeps every element aligned.
+    static bool arrayFits(uint64_t offset, uint64_t count, size_t elementBytes, uint64_t fileBytes) {
+        return offset % 64 == 0 && offset >= sizeof(TreeFileHeader) && offset <= fileBytes &&
+               count < (fileBytes - offset) / elementBytes;
+    }
+
+public:
+    MappedTree() = default;
+    MappedTree(const MappedTree &) = delete;
+    MappedTree &operator=(const MappedTree &) = delete;
+    ~MappedTree() { close(); }
+
+    bool open(const std::string &path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(TreeFileHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base = p;
+        mappedBytes = size_t(st.st_size);
+
+        const TreeFileHeader* h = static_cast<const TreeFileHeader*>(base);
+        bool hasValues = !std::is_same<Value, NoValue>::value;
+        if (std::memcmp(h->magic, TreeFileMagic, sizeof h->magic) != 0 || h->version != TreeFileVersion ||
+            h->keyBytes != sizeof(Key) || h->valueBytes != (hasValues ? sizeof(Value) : 0) ||
+            h->fileBytes > mappedBytes || !arrayFits(h->keysOffset, h->count, sizeof(Key), h->fileBytes) ||
+            (hasValues && !arrayFits(h->valuesOffset, h->count, sizeof(Value), h->fileBytes))) {
+            close();
+            return false;
+        }
+        count = size_t(h->count);
+        keys = reinterpret_cast<const Key*>(static_cast<const char*>(base) + h->keysOffset);
+        if (hasValues) values = reinterpret_cast<const Value*>(static_cast<const char*>(base) + h->valuesOffset);
+        return true;
+    }
+
+    void close() {
+        if (base) munmap(base, mappedBytes);
+        base = nullptr;
+        mappedBytes = 0;
+        keys = nullptr;
+        values = nullptr;
+        count = 0;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    bool contains(const Key &x) const {
+        size_t k = lowerBoundSlot(x);
+        return k != 0 && !(x < keys[k]);
+    }
+
+    // Value stored under x, or nullptr. Maps only: a set has no values
+    // array to point into.
+    const Value* find(const Key &x) const {
+        static_assert(!std::is_same<Value, NoValue>::value, "find() needs values; use contains() on a set");
+        size_t k = lowerBoundSlot(x);
+        return k != 0 && !(x < keys[k]) ? values + k : nullptr;
+    }
+
+    // Smallest key not less than x, if any
+    bool lowerBound(const Key &x, Key &out) const {
+        size_t k = lowerBoundSlot(x);
+        if (k == 0) return false;
+        out = keys[k];
+        return true;
+    }
+
+    // Visits keys (sets) or (key, value) in key order, following the
+    // implicit in-order successor without a stack
+    template <class F>
+    void forEach(F visit) const {
+        if (count == 0) return;
+        size_t k = 1;
+        while (2 * k <= count) k *= 2;
+        for (size_t i = 0; i < count; i++) {
+            if constexpr (std::is_same<Value, NoValue>::value) visit(keys[k]);
+            else visit(keys[k], values[k]);
+            if (2 * k + 1 <= count) {
+                k = 2 * k + 1;
+                while (2 * k <= count) k *= 2;
+            } else {
+                while (k & 1) k >>= 1;   // climb out of right subtrees
+                k >>= 1;
+            }
+        }
+    }
+};
+
+#endif
@@ -2,374 +2,59 @@
 #include <string>
 #include <sstream>
 #include <limits>
+#include "route.h"
 
 using namespace std;
 
-struct Station {
-    string name;
-    Station* prev;
-    Station* next;
-    Station(const string &n) : name(n), prev(nullptr), next(nullptr) {}
-};
-
-class Route {
-private:
-    Station* head;
-    Station* tail;
-    Station* current;     // pointer to simulate train position
-    bool isCircular;
-
-public:
-    Route() : head(nullptr), tail(nullptr), current(nullptr), isCircular(false) {}
-
-    ~Route() {
-        clear();
-    }
-
-    void clear() {
-        if (!head) return;
-        // If circular, break circle first
-        if (isCircular && tail) {
-            tail->next = nullptr;
-            head->prev = nullptr;
-        }
-        Station* ptr = head;
-        while (ptr) {
-            Station* nxt = ptr->next;
-            delete ptr;
-            ptr = nxt;
-        }
-        head = tail = current = nullptr;
-    }
-
-    bool empty() const {
-        return head == nullptr;
-    }
-
-    void setCircular(bool c) {
-        isCircular = c;
-        if (!head) return;
-        if (isCircular) {
-            head->prev = tail;
-            tail->next = head;
-        } else {
-            // break the links
-            head->prev = nullptr;
-            tail->next = nullptr;
-        }
-    }
-
-    void addStationEnd(const string &name) {
-        Station* node = new Station(name);
-        if (!head) {
-            head = tail = node;
-            if (isCircular) {
-                head->next = head->prev = head;
-            }
-        } else {
-            if (isCircular) {
-                // tail -> node -> head, maintain circular links
-                node->prev = tail;
-                node->next = head;
-                tail->next = node;
-                head->prev = node;
-                tail = node;
-            } else {
-                node->prev = tail;
-                tail->next = node;
-                tail = node;
-            }
-        }
-        if (!current) current = head; // set current if first station added
-    }
-
-    void addStationBeginning(const string &name) {
-        Station* node = new Station(name);
-        if (!head) {
-            head = tail = node;
-            if (isCircular) {
-                head->next = head->prev = head;
-            }
-        } else {
-            if (isCircular) {
-                node->next = head;
-                node->prev = tail;
-                head->prev = node;
-                tail->next = node;
-                head = node;
-            } else {
-                node->next = head;
-                head->prev = node;
-                head = node;
-            }
-        }
-        if (!current) current = head;
-    }
-
-    bool insertAfter(const string &afterName, const string &name) {
-        Station* p = findStationPtr(afterName);
-        if (!p) return false;
-        Station* node = new Station(name);
-        if (isCircular && p == tail) {
-            // inserting after tail: new tail
-            node->prev = tail;
-            node->next = head;
-            tail->next = node;
-            head->prev = node;
-            tail = node;
-        } else if (!isCircular && p == tail) {
-            // normal tail insertion
-            node->prev = tail;
-            tail->next = node;
-            tail = node;
-        } else {
-            // middle insertion
-            Station* nxt = p->next;
-            node->next = nxt;
-            node->prev = p;
-            p->next = node;
-            if (nxt) nxt->prev = node;
-        }
-        return true;
-    }
-
-    bool removeStation(const string &name) {
-        Station* p = findStationPtr(name);
-        if (!p) return false;
-
-        if (p == head && p == tail) {
-            // only one node
-            delete p;
-            head = tail = current = nullptr;
-            return true;
-        }
-
-        if (isCircular) {
-            // update neighbors
-            p->prev->next = p->next;
-            p->next->prev = p->prev;
-            if (p == head) head = p->next;
-            if (p == tail) tail = p->prev;
-        } else {
-            if (p->prev) p->prev->next = p->next;
-            if (p->next) p->next->prev = p->prev;
-            if (p == head) head = p->next;
-            if (p == tail) tail = p->prev;
-        }
-
-        // move current if it pointed to deleted node
-        if (current == p) {
-            current = p->next ? p->next : head;
-        }
-
-        delete p;
-        return true;
-    }
-
-    Station* findStationPtr(const string &name) const {
-        if (!head) return nullptr;
-        Station* ptr = head;
-        if (isCircular) {
-            do {
-                if (ptr->name == name) return ptr;
-                ptr = ptr->next;
-            } while (ptr != head);
-            return nullptr;
-        } else {
-            while (ptr) {
-                if (ptr->name == name) return ptr;
-                ptr = ptr->next;
-            }
-            return nullptr;
-        }
-    }
-
-    bool findStation(const string &name) const {
-        return findStationPtr(name) != nullptr;
-    }
-
-    void displayForward() const {
-        if (!head) {
-            cout << "[Empty route]\n";
-            return;
-        }
-        cout << "Route (forward): ";
-        Station* ptr = head;
-        if (isCircular) {
-            bool first = true;
-            do {
-                cout << (first ? "" : " -> ") << ptr->name;
-                first = false;
-                ptr = ptr->next;
-            } while (ptr != head);
-        } else {
-            while (ptr) {
-                cout << ptr->name;
-                if (ptr->next) cout << " -> ";
-                ptr = ptr->next;
-            }
-        }
-        cout << "\n";
-    }
-
-    void displayBackward() const {
-        if (!tail) {
-            cout << "[Empty route]\n";
-            return;
-        }
-        cout << "Route (backward): ";
-        Station* ptr = tail;
-        if (isCircular) {
-            bool first = true;
-            do {
-                cout << (first ? "" : " -> ") << ptr->name;
-                first = false;
-                ptr = ptr->prev;
-            } while (ptr != tail);
-        } else {
-            while (ptr) {
-                cout << ptr->name;
-                if (ptr->prev) cout << " -> ";
-                ptr = ptr->prev;
-            }
-        }
-        cout << "\n";
-    }
-
-    void setCurrentAt(const string &name) {
-        Station* p = findStationPtr(name);
-        if (!p) {
-            cout << "Station '" << name << "' not found.\n";
-            return;
-        }
-        current = p;
-        cout << "Current position set to '" << current->name << "'.\n";
-    }
-
-    void resetCurrentToHead() {
-        current = head;
-        if (current) cout << "Current position set to head: " << current->name << "\n";
-        else cout << "Route is empty.\n";
-    }
-
-    void moveNext(int steps = 1) {
-        if (!current) {
-            cout << "No current station set.\n";
-            return;
-        }
-        for (int i = 0; i < steps; ++i) {
-            if (current->next) current = current->next;
-            else {
-                cout << "Reached end of linear route, cannot move next further.\n";
-                return;
-            }
-        }
-        cout << "Now at: " << current->name << "\n";
-    }
-
-    void movePrev(int steps = 1) {
-        if (!current) {
-            cout << "No current station set.\n";
-            return;
-        }
-        for (int i = 0; i < steps; ++i) {
-            if (current->prev) current = current->prev;
-            else {
-                cout << "Reached start of linear route, cannot move previous further.\n";
-                return;
-            }
-        }
-        cout << "Now at: " << current->name << "\n";
-    }
-
-    void showCurrent() const {
-        if (!current) cout << "No current station set.\n";
-        else cout << "Current station: " << current->name << "\n";
-    }
-
-    void displayDetailed() const {
-        cout << "Route details:\n";
-        cout << (isCircular ? "Type: Circular\n" : "Type: Linear\n");
-        displayForward();
-        displayBackward();
-        if (current) cout << "Current station: " << current->name << "\n";
-    }
-
-    // Utility to create a sample route quickly
-    void createSampleRoute() {
-        clear();
-        addStationEnd("StationA");
-        addStationEnd("StationB");
-        addStationEnd("StationC");
-        addStationEnd("StationD");
-        addStationEnd("StationE");
-        resetCurrentToHead();
-        cout << "Sample route created (A->B->C->D->E).\n";
-    }
-
-    // Simulate travel between two named stations (linear calculation)
-    void travelBetween(const string &from, const string &to) {
-        Station* f = findStationPtr(from);
-        Station* t = findStationPtr(to);
-        if (!f || !t) {
-            cout << "One or both stations not found.\n";
-            return;
-        }
-        // If circular route, we can decide shortest path in steps (both directions)
-        if (isCircular) {
-            // measure steps forward
-            int forwardSteps = 0;
-            Station* p = f;
-            while (p->name != t->name) {
-                p = p->next; forwardSteps++;
-                if (p == f) break; // safety
-            }
-            // measure steps backward
-            int backwardSteps = 0;
-            p = f;
-            while (p->name != t->name) {
-                p = p->prev; backwardSteps++;
-                if (p == f) break;
-            }
-            cout << "Travel from " << from << " to " << to << " (circular): choose ";
-            if (forwardSteps <= backwardSteps) {
-                cout << "forward (" << forwardSteps << " stops).\n";
-            } else {
-                cout << "backward (" << backwardSteps << " stops).\n";
-            }
-        } else {
-            // linear: find direction if possible
-            // try forward
-            int forwardSteps = 0;
-            Station* p = f;
-            while (p && p->name != t->name) {
-                p = p->next; forwardSteps++;
-            }
-            // try backward
-            int backwardSteps = 0;
-            p = f;
-            while (p && p->name != t->name) {
-                p = p->prev; backwardSteps++;
-            }
-            if (p == nullptr) {
-                cout << "No path from " << from << " to " << to << " in linear route.\n";
-            } else {
-                if (forwardSteps < backwardSteps) {
-                    cout << "Travel forward " << forwardSteps << " stops from " << from << " to " << to << ".\n";
-                } else {
-                    cout << "Travel backward " << backwardSteps << " stops from " << from << " to " << to << ".\n";
-                }
-            }
-        }
-    }
-};
-
 // Helper to read full line after numeric input
 void readLineAfterInt() {
     cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
-int main() {
+// --check: travelBetween's advice on the sample route, linear and
+// circular. Destinations ahead on a linear route used to get "No path".
+int checkTravel() {
+    struct Case {
+        bool circular;
+        const char* from;
+        const char* to;
+        const char* expected;
+    };
+    const Case cases[] = {
+        {false, "StationB", "StationD", "Travel forward 2 stops from StationB to StationD.\n"},
+        {false, "StationA", "StationE", "Travel forward 4 stops from StationA to StationE.\n"},
+        {false, "StationD", "StationB", "Travel backward 2 stops from StationD to StationB.\n"},
+        {false, "StationC", "StationC", "Travel backward 0 stops from StationC to StationC.\n"},
+        {false, "StationA", "Nowhere", "One or both stations not found.\n"},
+        {true, "StationA", "StationE", "Travel from StationA to StationE (circular): choose backward (1 stops).\n"},
+        {true, "StationB", "StationD", "Travel from StationB to StationD (circular): choose forward (2 stops).\n"},
+    };
+    Route route;
+    ostringstream out;
+    streambuf* saved = cout.rdbuf(out.rdbuf());
+    route.createSampleRoute();
+    cout.rdbuf(saved);
+
+    int failures = 0;
+    for (const Case &c : cases) {
+        route.setCircular(c.circular);
+        out.str("");
+        saved = cout.rdbuf(out.rdbuf());
+        route.travelBetween(c.from, c.to);
+        cout.rdbuf(saved);
+        if (out.str() != c.expected) {
+            failures++;
+            cout << "FAIL: " << c.from << " to " << c.to << "\n  expected: " << c.expected << "  got:      " << out.str();
+        }
+    }
+    cout << (failures ? "FAILED: " : "OK: ") << failures << " of " << size(cases) << " travel checks failed\n";
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--check") return checkTravel();
+    // --metrics file: write a Prometheus snapshot there on exit
+    string metricsPath = argc > 2 && string(argv[1]) == "--metrics" ? argv[2] : "";
     Route route;
     int choice;
     cout << "=== Virtual Train Route Planner ===\n";
@@ -392,9 +77,11 @@ int main() {
         cout << "14. Search station\n";
         cout << "15. Travel between two stations (suggest direction)\n";
         cout << "16. Route details\n";
+        cout << "17. Show statistics\n";
         cout << "0. Exit\n";
         cout << "Enter choice: ";
         if (!(cin >> choice)) {
+            if (cin.eof()) break;   // end of input exits like choice 0
             cin.clear();
             readLineAfterInt();
             cout << "Invalid input. Try again.\n";
@@ -485,11 +172,19 @@ int main() {
             case 16:
                 route.displayDetailed();
                 break;
+            case 17:
+                dumpStats(cout);
+                writePrometheus(cout);
+                break;
             default:
                 cout << "Invalid choice.\n";
         }
     }
 
     cout << "Exiting planner. Bye!\n";
+    if (!metricsPath.empty() && !writePrometheusFile(metricsPath)) {
+        cout << "Cannot write " << metricsPath << "\n";
+        return 1;
+    }
     return 0;
 }